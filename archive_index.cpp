@@ -0,0 +1,185 @@
+#include "archive_index.h"
+
+#include <algorithm>
+
+#include "manifest.h"
+
+const uint64_t ArchiveIndex::MAGIC = 0x58494648;
+const uint64_t ArchiveIndex::COMPACT_MAGIC = 0x32494648;
+const size_t ArchiveIndex::SIZE_OF_TRAILER = 12;
+const size_t ArchiveIndex::MAX_NAME_SIZE = (1 << 16);
+
+void ArchiveIndex::Push(BitWriter& writer) const {
+    uint64_t offset_of_index = writer.BitsWritten() / 8;
+
+    writer.Put(COMPACT_MAGIC, 32);
+    Manifest::PushNumber(writer, entries.size());
+
+    const std::string* previous_name = nullptr;
+    uint64_t end_of_previous_member = 0;
+
+    for (const auto& entry : entries) {
+        size_t size_of_prefix = 0;
+
+        if (previous_name != nullptr) {
+            size_t max_size_of_prefix = std::min(previous_name->size(), entry.name.size());
+
+            size_of_prefix = std::mismatch(previous_name->begin(),
+                                           previous_name->begin() + max_size_of_prefix,
+                                           entry.name.begin())
+                                 .first -
+                             previous_name->begin();
+        }
+
+        Manifest::PushNumber(writer, size_of_prefix);
+        Manifest::PushNumber(writer, entry.name.size() - size_of_prefix);
+        writer.PutBytes(entry.name.data() + size_of_prefix, entry.name.size() - size_of_prefix);
+
+        int64_t difference = static_cast<int64_t>(entry.start_bit - end_of_previous_member);
+
+        Manifest::PushNumber(writer, (static_cast<uint64_t>(difference) << 1) ^
+                                         static_cast<uint64_t>(difference >> 63));
+        Manifest::PushNumber(writer, entry.original_size);
+        Manifest::PushNumber(writer, entry.compressed_bits);
+
+        previous_name = &entry.name;
+        end_of_previous_member = entry.start_bit + entry.compressed_bits;
+    }
+
+    PushNumber(writer, offset_of_index);
+    writer.Put(COMPACT_MAGIC, 32);
+}
+
+void ArchiveIndex::Read(BitReader& reader) {
+    uint64_t magic = reader.Read(32);
+
+    entries.clear();
+
+    if (magic == COMPACT_MAGIC) {
+        ReadCompactEntries(reader);
+    } else if (magic == MAGIC) {
+        ReadEntries(reader);
+    } else {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    ReadNumber(reader);
+
+    if (reader.Read(32) != magic) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+}
+
+void ArchiveIndex::ReadCompactEntries(BitReader& reader) {
+    uint64_t number_of_entries = Manifest::ReadNumber(reader);
+
+    std::string previous_name;
+    uint64_t end_of_previous_member = 0;
+
+    for (uint64_t index = 0; index < number_of_entries; ++index) {
+        Entry entry;
+
+        uint64_t size_of_prefix = Manifest::ReadNumber(reader);
+        uint64_t size_of_rest = Manifest::ReadNumber(reader);
+
+        if (size_of_prefix > previous_name.size() || size_of_rest > MAX_NAME_SIZE) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        entry.name = previous_name.substr(0, size_of_prefix);
+        entry.name.resize(size_of_prefix + size_of_rest);
+        reader.ReadBytes(entry.name.data() + size_of_prefix, size_of_rest);
+
+        uint64_t difference = Manifest::ReadNumber(reader);
+
+        entry.start_bit =
+            end_of_previous_member + ((difference >> 1) ^ (~(difference & 1) + 1));
+        entry.original_size = Manifest::ReadNumber(reader);
+        entry.compressed_bits = Manifest::ReadNumber(reader);
+
+        previous_name = entry.name;
+        end_of_previous_member = entry.start_bit + entry.compressed_bits;
+
+        entries.push_back(std::move(entry));
+    }
+}
+
+void ArchiveIndex::ReadEntries(BitReader& reader) {
+    uint64_t number_of_entries = ReadNumber(reader);
+
+    for (uint64_t index = 0; index < number_of_entries; ++index) {
+        Entry entry;
+
+        entry.name.resize(reader.Read(32));
+
+        if (entry.name.size() > MAX_NAME_SIZE) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        reader.ReadBytes(entry.name.data(), entry.name.size());
+
+        entry.start_bit = ReadNumber(reader);
+        entry.original_size = ReadNumber(reader);
+        entry.compressed_bits = ReadNumber(reader);
+
+        entries.push_back(std::move(entry));
+    }
+}
+
+bool ArchiveIndex::ReadFromEnd(const char* archive_name) {
+    std::ifstream in(archive_name, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+
+    if (!in.is_open()) {
+        throw std::runtime_error("error - cannot open file named " +
+                                 static_cast<std::string>(archive_name));
+    }
+
+    uint64_t size_of_archive = static_cast<uint64_t>(in.tellg());
+
+    if (size_of_archive < SIZE_OF_TRAILER) {
+        return false;
+    }
+
+    char trailer[SIZE_OF_TRAILER];
+
+    in.seekg(static_cast<std::streamoff>(size_of_archive - SIZE_OF_TRAILER));
+    in.read(trailer, SIZE_OF_TRAILER);
+
+    BitReader trailer_reader(trailer, SIZE_OF_TRAILER);
+
+    uint64_t offset_of_index = ReadNumber(trailer_reader);
+
+    uint64_t magic = trailer_reader.Read(32);
+
+    if ((magic != MAGIC && magic != COMPACT_MAGIC) || offset_of_index >= size_of_archive) {
+        return false;
+    }
+
+    BitReader reader(archive_name);
+    reader.SeekToBit(offset_of_index * 8);
+
+    Read(reader);
+
+    return true;
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::Find(const std::string& name) const {
+    for (const auto& entry : entries) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+void ArchiveIndex::PushNumber(BitWriter& writer, uint64_t number) const {
+    writer.Put(number & 0xFFFFFFFF, 32);
+    writer.Put(number >> 32, 32);
+}
+
+uint64_t ArchiveIndex::ReadNumber(BitReader& reader) const {
+    uint64_t lower_half = reader.Read(32);
+
+    return lower_half | (reader.Read(32) << 32);
+}
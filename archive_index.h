@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+
+#include "bit_reader.h"
+#include "bit_writer.h"
+
+// An optional footer written after ARCHIVE_END and the padding of the last byte:
+// COMPACT_MAGIC, number of members, (name, start bit, original size, compressed bits) of every
+// member, 64-bit byte offset of the footer, COMPACT_MAGIC. Names are front-coded against the name
+// before them and the other numbers are written as in a Manifest; the start bit is the difference
+// from the end of the member before, so it is zero for all but the first member of a section.
+// Footers of older archives start and end with MAGIC and hold a 32-bit name length and 64-bit
+// numbers; they are still read.
+class ArchiveIndex {
+public:
+    const static uint64_t MAGIC;
+    const static uint64_t COMPACT_MAGIC;
+    const static size_t SIZE_OF_TRAILER;
+    const static size_t MAX_NAME_SIZE;
+
+    struct Entry {
+        std::string name;
+        uint64_t start_bit = 0;
+        uint64_t original_size = 0;
+        uint64_t compressed_bits = 0;
+    };
+
+    // The writer must stand on a byte boundary.
+    void Push(BitWriter& writer) const;
+
+    void Read(BitReader& reader);
+
+    void ReadCompactEntries(BitReader& reader);
+
+    void ReadEntries(BitReader& reader);
+
+    // Returns false if the archive has no index.
+    bool ReadFromEnd(const char* archive_name);
+
+    const Entry* Find(const std::string& name) const;
+
+    void PushNumber(BitWriter& writer, uint64_t number) const;
+
+    uint64_t ReadNumber(BitReader& reader) const;
+
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,279 @@
+#include "archive_reader.h"
+
+#include <algorithm>
+
+ArchiveReader::ArchiveReader(const std::string& archive_name, const Archiver& archiver)
+    : archiver(archiver), archive_reader(archiver.OpenReader(archive_name)) {
+    if (archive_name != Archiver::STANDARD_STREAM_NAME) {
+        index.ReadFromEnd(archive_name.c_str());
+    }
+
+    if (archive_reader->Available() <= Archiver::NUMBER_OF_BITS_IN_BYTE) {
+        terminator = Huffman::ARCHIVE_END;
+        is_end_read = true;
+    } else {
+        manifest = archiver.ReadManifest(*archive_reader);
+        shared_tables = archiver.ReadSharedTables(*archive_reader);
+    }
+}
+
+bool ArchiveReader::NextMember(Member& member) {
+    SkipRestOfMember();
+
+    if (terminator != Huffman::ONE_MORE_FILE) {
+        return false;
+    }
+
+    BitReader& reader = *archive_reader;
+
+    type_of_member = reader.Read(Archiver::ALPHABET_SIZE);
+    member = Member();
+    is_in_member = true;
+
+    has_checksum = (type_of_member == Archiver::CHECKSUMMED_MEMBER ||
+                    type_of_member == Archiver::CHECKSUMMED_MEMBER_WITH_NAME);
+    is_name_checksummed = (type_of_member == Archiver::CHECKSUMMED_MEMBER_WITH_NAME);
+    is_checksum_computed = true;
+    checksum = 0;
+
+    if (has_checksum) {
+        type_of_member = reader.Read(Archiver::ALPHABET_SIZE);
+        member.has_checksum = true;
+    }
+
+    if (type_of_member == Archiver::BLOCKED_MEMBER) {
+        member.name = archiver.ReadString(reader);
+
+        block.clear();
+        position_in_block = 0;
+    } else if (type_of_member == Archiver::STORED_MEMBER ||
+               type_of_member == Archiver::RLE_MEMBER) {
+        member.name = archiver.ReadString(reader);
+        member.is_size_known = true;
+        member.size = archiver.ReadSize(reader);
+
+        size_left = member.size;
+
+        if (type_of_member == Archiver::RLE_MEMBER) {
+            rle_byte = static_cast<char>(reader.Read(Archiver::NUMBER_OF_BITS_IN_BYTE));
+        }
+    } else {
+        if (type_of_member == Archiver::SHARED_TABLE_MEMBER) {
+            size_t number_of_table = reader.Read(Archiver::ALPHABET_SIZE);
+
+            if (number_of_table >= shared_tables.size()) {
+                throw std::runtime_error("error - wrong data in archive file");
+            }
+
+            huffman_of_member = &shared_tables[number_of_table];
+        } else {
+            size_t number_of_symbols = type_of_member;
+
+            huffman.GetOrderOfSymbols(reader, number_of_symbols);
+            huffman.GetCodeOfSymbols(reader, number_of_symbols);
+
+            huffman_of_member = &huffman;
+        }
+
+        type_of_member = Archiver::HUFFMAN_MEMBER;
+
+        int next_value = huffman_of_member->DecodeNextSymbol(reader);
+
+        while (next_value != Huffman::FILENAME_END) {
+            member.name += huffman_of_member->TransformIntToChar(next_value);
+
+            next_value = huffman_of_member->DecodeNextSymbol(reader);
+        }
+    }
+
+    name_of_member = member.name;
+
+    if (member.is_size_known && size_left == 0) {
+        EndMember(static_cast<int>(reader.Read(Archiver::ALPHABET_SIZE)));
+    }
+
+    if (number_of_members < index.entries.size() &&
+        index.entries[number_of_members].name == member.name) {
+        member.is_size_known = true;
+        member.size = index.entries[number_of_members].original_size;
+    }
+
+    ++number_of_members;
+
+    return true;
+}
+
+size_t ArchiveReader::Read(char* buffer, size_t count) {
+    if (!is_in_member || count == 0) {
+        return 0;
+    }
+
+    if (type_of_member == Archiver::HUFFMAN_MEMBER) {
+        return ReadFromHuffmanMember(buffer, count);
+    }
+
+    if (type_of_member == Archiver::BLOCKED_MEMBER) {
+        return ReadFromBlockedMember(buffer, count);
+    }
+
+    BitReader& reader = *archive_reader;
+
+    count = std::min<uint64_t>(count, size_left);
+
+    if (type_of_member == Archiver::STORED_MEMBER) {
+        reader.ReadBytes(buffer, count);
+    } else {
+        std::fill(buffer, buffer + count, rle_byte);
+    }
+
+    checksum = Crc32c::Extend(checksum, buffer, count);
+    size_left -= count;
+
+    if (size_left == 0) {
+        EndMember(static_cast<int>(reader.Read(Archiver::ALPHABET_SIZE)));
+    }
+
+    return count;
+}
+
+size_t ArchiveReader::ReadFromHuffmanMember(char* buffer, size_t count) {
+    BitReader& reader = *archive_reader;
+
+    for (size_t index = 0; index < count; ++index) {
+        int next_value = huffman_of_member->DecodeNextSymbol(reader);
+
+        if (next_value == Huffman::ONE_MORE_FILE || next_value == Huffman::ARCHIVE_END) {
+            checksum = Crc32c::Extend(checksum, buffer, index);
+            EndMember(next_value);
+
+            return index;
+        }
+
+        buffer[index] = huffman_of_member->TransformIntToChar(next_value);
+    }
+
+    checksum = Crc32c::Extend(checksum, buffer, count);
+
+    return count;
+}
+
+size_t ArchiveReader::ReadFromBlockedMember(char* buffer, size_t count) {
+    if (position_in_block == block.size()) {
+        ReadNextBlock(true);
+
+        if (!is_in_member) {
+            return 0;
+        }
+    }
+
+    count = std::min(count, block.size() - position_in_block);
+
+    std::copy(block.begin() + position_in_block, block.begin() + position_in_block + count,
+              buffer);
+    position_in_block += count;
+
+    return count;
+}
+
+void ArchiveReader::ReadNextBlock(bool is_decoded) {
+    BitReader& reader = *archive_reader;
+
+    size_t size_of_block = reader.Read(32);
+
+    if (size_of_block == 0) {
+        EndMember(static_cast<int>(reader.Read(Archiver::ALPHABET_SIZE)));
+        return;
+    }
+
+    size_t size_of_compressed_block = reader.Read(32);
+
+    if (size_of_block > Archiver::MAX_BLOCK_SIZE ||
+        size_of_compressed_block > size_of_block + Archiver::MAX_BLOCK_OVERHEAD) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    compressed_block.resize(size_of_compressed_block);
+    reader.ReadBytes(compressed_block.data(), size_of_compressed_block);
+
+    if (!is_decoded) {
+        is_checksum_computed = false;
+        return;
+    }
+
+    block.resize(size_of_block);
+    position_in_block = 0;
+
+    archiver.DecompressBlock(compressed_block.data(), compressed_block.size(), block.data(),
+                             block.size(), huffman);
+
+    checksum = Crc32c::Extend(checksum, block.data(), block.size());
+}
+
+void ArchiveReader::EndMember(int terminator_of_member) {
+    terminator = terminator_of_member;
+    is_in_member = false;
+
+    if (is_name_checksummed) {
+        checksum = Crc32c::Extend(checksum, name_of_member.data(), name_of_member.size());
+    }
+
+    if (has_checksum && archive_reader->Read(32) != checksum && is_checksum_computed) {
+        throw std::runtime_error("error - wrong checksum of file named " + name_of_member);
+    }
+}
+
+void ArchiveReader::SkipRestOfMember() {
+    if (type_of_member == Archiver::BLOCKED_MEMBER) {
+        // The blocks are not decoded, only read.
+        while (is_in_member) {
+            ReadNextBlock(false);
+        }
+    }
+
+    std::vector<char> buffer(is_in_member ? BitReader::BUFFER_SIZE : 0);
+
+    while (is_in_member) {
+        Read(buffer.data(), buffer.size());
+    }
+
+    if (is_end_read) {
+        return;
+    }
+
+    if (terminator == Huffman::ARCHIVE_END) {
+        ReadEndOfArchive();
+    } else if (terminator != Huffman::ONE_MORE_FILE) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+}
+
+void ArchiveReader::ReadEndOfArchive() {
+    BitReader& reader = *archive_reader;
+
+    reader.AlignToByte();
+
+    // The index of the archive before members were appended to it, or the last one.
+    if (!reader.IsEnd() && reader.Peek(Archiver::ALPHABET_SIZE) != Archiver::APPENDED_MEMBERS) {
+        ArchiveIndex index_of_archive;
+        index_of_archive.Read(reader);
+    }
+
+    if (!reader.IsEnd() && reader.Peek(Archiver::ALPHABET_SIZE) == Archiver::APPENDED_MEMBERS) {
+        reader.Consume(Archiver::ALPHABET_SIZE);
+
+        Archiver::Section section = archiver.ReadSection(reader);
+
+        manifest.entries.insert(manifest.entries.end(), section.manifest.entries.begin(),
+                                section.manifest.entries.end());
+        shared_tables = std::move(section.shared_tables);
+
+        terminator = Huffman::ONE_MORE_FILE;
+        return;
+    }
+
+    if (!reader.IsEnd()) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    is_end_read = true;
+}
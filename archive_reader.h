@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "archiver.h"
+
+// Reads the members of an archive one after another without writing them to files. Only one
+// block of a blocked member is kept in memory at once.
+class ArchiveReader {
+public:
+    struct Member {
+        std::string name;
+        // Known for stored and RLE members and for all members of an archive with an index.
+        bool is_size_known = false;
+        uint64_t size = 0;
+        bool has_checksum = false;
+    };
+
+    ArchiveReader(const std::string& archive_name, const Archiver& archiver = Archiver());
+
+    // Skips the rest of the current member. Returns false if there are no more members.
+    bool NextMember(Member& member);
+
+    // Returns the number of bytes written to buffer, which is 0 only at the end of the member.
+    size_t Read(char* buffer, size_t count);
+
+    void SkipRestOfMember();
+
+    size_t ReadFromHuffmanMember(char* buffer, size_t count);
+
+    size_t ReadFromBlockedMember(char* buffer, size_t count);
+
+    // Only reads the compressed block if is_decoded is false.
+    void ReadNextBlock(bool is_decoded);
+
+    // Reads the checksum after the terminator and compares it with the one of the bytes read,
+    // unless the member was skipped without decoding.
+    void EndMember(int terminator_of_member);
+
+    // Goes on to the members appended to the archive, if there are any.
+    void ReadEndOfArchive();
+
+    Archiver archiver;
+
+    std::unique_ptr<BitReader> archive_reader;
+    ArchiveIndex index;
+    size_t number_of_members = 0;
+
+    int terminator = Huffman::ONE_MORE_FILE;
+    bool is_in_member = false;
+    bool is_end_read = false;
+
+    size_t type_of_member = Archiver::HUFFMAN_MEMBER;
+    // The bytes left in a stored or RLE member.
+    uint64_t size_left = 0;
+    char rle_byte = 0;
+
+    std::string name_of_member;
+    bool has_checksum = false;
+    bool is_name_checksummed = false;
+    bool is_checksum_computed = false;
+    uint32_t checksum = 0;
+
+    Manifest manifest;
+    std::vector<Huffman> shared_tables;
+    Huffman huffman;
+    // The table of the current Huffman member, which is huffman or one of the shared tables.
+    const Huffman* huffman_of_member = &huffman;
+
+    std::vector<char> compressed_block;
+    std::vector<char> block;
+    size_t position_in_block = 0;
+};
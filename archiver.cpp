@@ -6,118 +6,2107 @@ const size_t Archiver::ALPHABET_SIZE = 9;
 const size_t Archiver::FILENAME_END = 256;
 const size_t Archiver::ONE_MORE_FILE = 257;
 const size_t Archiver::ARCHIVE_END = 258;
+const size_t Archiver::DEFAULT_MAX_BUFFERED_FILE_SIZE = (1 << 26);
+const size_t Archiver::BLOCKED_MEMBER = 511;
+const size_t Archiver::STORED_MEMBER = 510;
+const size_t Archiver::RLE_MEMBER = 509;
+const size_t Archiver::CHECKSUMMED_MEMBER = 508;
+const size_t Archiver::SHARED_TABLE = 507;
+const size_t Archiver::MANIFEST = 505;
+const size_t Archiver::APPENDED_MEMBERS = 504;
+const size_t Archiver::CHECKSUMMED_MEMBER_WITH_NAME = 503;
+const size_t Archiver::SHARED_TABLE_MEMBER = 506;
+const size_t Archiver::MAX_NUMBER_OF_SHARED_TABLES = 64;
+const size_t Archiver::NUMBER_OF_CLUSTERING_ROUNDS = 4;
+const size_t Archiver::MAX_NUMBER_OF_SAMPLES = 256;
+const size_t Archiver::HUFFMAN_MEMBER = 0;
+const size_t Archiver::HUFFMAN_BLOCK = 0;
+const size_t Archiver::LIMITED_HUFFMAN_BLOCK = 1;
+const size_t Archiver::INTERLEAVED_HUFFMAN_BLOCK = 2;
+const size_t Archiver::STORED_BLOCK = 3;
+const size_t Archiver::RLE_BLOCK = 4;
+const size_t Archiver::LZ77_BLOCK = 5;
+const size_t Archiver::CONTEXT_HUFFMAN_BLOCK = 6;
+const size_t Archiver::LIMITED_LZ77_BLOCK = 7;
+const size_t Archiver::LIMITED_CONTEXT_HUFFMAN_BLOCK = 8;
+const size_t Archiver::CHECKSUMMED_BLOCK = 0x80;
+const size_t Archiver::NUMBER_OF_STREAMS = 4;
+const size_t Archiver::MAX_BLOCK_SIZE = (1 << 30);
+const size_t Archiver::MAX_BLOCK_OVERHEAD = 1 + 17 + sizeof(uint32_t);
+const size_t Archiver::MAX_NUMBER_OF_THREADS = 256;
+const std::string Archiver::STANDARD_STREAM_NAME = "-";
+const size_t Archiver::STREAMING_BLOCK_SIZE = (1 << 20);
 
 void Archiver::Decompress(const char* file_name) const {
-    Huffman huffman(file_name);
+    auto start = std::chrono::steady_clock::now();
+
+    FileStatistics total;
+
+    if (number_of_threads > 1 && file_name != STANDARD_STREAM_NAME) {
+        ArchiveIndex index;
+
+        if (index.ReadFromEnd(file_name) && CanDecompressInParallel(index)) {
+            DecompressInParallel(file_name, index, total);
+
+            PrintTotalStatistics(total, start);
+            return;
+        }
+    }
+
+    std::unique_ptr<BitReader> archive_reader = OpenReader(file_name);
+    BitReader& reader = *archive_reader;
+
+    if (reader.Available() <= NUMBER_OF_BITS_IN_BYTE) {
+        return;
+    }
+
+    ThreadPool pool(number_of_threads > 1 ? number_of_threads : 0);
+
+    std::vector<Section> sections;
+    sections.push_back(ReadSection(reader));
+
+    while (true) {
+        const Section& section = sections.back();
+        section.manifest.CreateDirectories();
+
+        size_t terminator = ONE_MORE_FILE;
+
+        while (terminator == ONE_MORE_FILE) {
+            FileStatistics statistics;
+            statistics.is_timed = print_statistics;
+
+            terminator = DecompressNextMember(reader, pool, section.shared_tables, statistics);
+
+            AddFileToStatistics(total, statistics);
+        }
+
+        if (terminator != ARCHIVE_END) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        reader.AlignToByte();
+
+        // The index of the archive before members were appended to it, or the last one.
+        if (!reader.IsEnd() && reader.Peek(ALPHABET_SIZE) != APPENDED_MEMBERS) {
+            ArchiveIndex index;
+            index.Read(reader);
+        }
+
+        if (reader.IsEnd() || reader.Peek(ALPHABET_SIZE) != APPENDED_MEMBERS) {
+            break;
+        }
+
+        reader.Consume(ALPHABET_SIZE);
+        sections.push_back(ReadSection(reader));
+    }
+
+    if (!reader.IsEnd()) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    for (const auto& section : sections) {
+        section.manifest.RestoreMetadata();
+    }
+
+    PrintTotalStatistics(total, start);
+}
+
+bool Archiver::CanDecompressInParallel(const ArchiveIndex& index) const {
+    if (index.entries.size() < 2) {
+        return false;
+    }
+
+    std::unordered_set<std::string> names;
+
+    for (const auto& entry : index.entries) {
+        if (entry.name == STANDARD_STREAM_NAME || !names.insert(entry.name).second) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Archiver::DecompressInParallel(const char* file_name, const ArchiveIndex& index,
+                                    FileStatistics& total) const {
+    const size_t number_of_files = index.entries.size();
+    const size_t number_of_tasks = std::min(number_of_threads, number_of_files);
+
+    std::vector<FileStatistics> statistics(number_of_files);
+
+    const std::vector<Section> sections = ReadSections(file_name, index);
+
+    // The number of the section of every member.
+    std::vector<size_t> section_of_file(number_of_files);
+
+    for (size_t section = 0; section < sections.size(); ++section) {
+        sections[section].manifest.CreateDirectories();
+
+        std::fill(section_of_file.begin() + sections[section].first_member,
+                  section_of_file.end(), section);
+    }
+
+    ThreadPool pool(number_of_tasks);
+
+    pool.Run(number_of_tasks, [&](size_t task) {
+        BitReader reader(file_name);
+
+        // Blocks of a member are decoded on the thread of the member.
+        ThreadPool serial_pool(0);
+
+        for (size_t file_index = task; file_index < number_of_files;
+             file_index += number_of_tasks) {
+            const ArchiveIndex::Entry& entry = index.entries[file_index];
+            const Section& section = sections[section_of_file[file_index]];
+
+            reader.SeekToBit(entry.start_bit);
+
+            statistics[file_index].is_timed = print_statistics;
+
+            uint64_t bits_read = reader.BitsRead();
+
+            size_t terminator = DecompressNextMember(reader, serial_pool, section.shared_tables,
+                                                     statistics[file_index]);
+
+            // The last member of every section ends the archive as it was before appending.
+            size_t expected_terminator =
+                (file_index + 1 == number_of_files ||
+                         section_of_file[file_index + 1] != section_of_file[file_index]
+                     ? ARCHIVE_END
+                     : ONE_MORE_FILE);
+
+            if (terminator != expected_terminator || statistics[file_index].name != entry.name ||
+                reader.BitsRead() - bits_read != entry.compressed_bits) {
+                throw std::runtime_error("error - wrong data in archive file");
+            }
+        }
+    });
+
+    for (const auto& section : sections) {
+        section.manifest.RestoreMetadata();
+    }
+
+    for (const auto& file_statistics : statistics) {
+        AddFileToStatistics(total, file_statistics);
+    }
+}
+
+void Archiver::Extract(const char* archive_name, const std::string& member_name) const {
+    ArchiveIndex index;
+
+    if (!index.ReadFromEnd(archive_name)) {
+        throw std::runtime_error("error - archive has no index, use -d to decompress it");
+    }
+
+    const ArchiveIndex::Entry* entry = index.Find(member_name);
+
+    if (entry == nullptr) {
+        throw std::runtime_error("error - no file named " + member_name + " in archive");
+    }
+
+    const std::vector<Section> sections = ReadSections(archive_name, index);
+
+    // The last section starting at or before the member.
+    const size_t number_of_member = entry - index.entries.data();
+    const Section& section = *std::prev(std::upper_bound(
+        sections.begin(), sections.end(), number_of_member,
+        [](size_t member, const Section& section) { return member < section.first_member; }));
+
+    const Manifest& manifest = section.manifest;
+    manifest.CreateDirectories();
+
+    BitReader reader(archive_name);
+    reader.SeekToBit(entry->start_bit);
+
+    ThreadPool pool(number_of_threads > 1 ? number_of_threads : 0);
+
+    FileStatistics statistics;
+    statistics.is_timed = print_statistics;
+
+    size_t terminator = DecompressNextMember(reader, pool, section.shared_tables, statistics);
+
+    if (terminator != ONE_MORE_FILE && terminator != ARCHIVE_END) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    for (const auto& manifest_entry : manifest.entries) {
+        if (!manifest_entry.is_directory && manifest_entry.path == member_name) {
+            manifest.RestoreMetadata(manifest_entry);
+        }
+    }
+
+    if (print_statistics) {
+        statistics.Print(std::cerr, statistics.GetSeconds());
+    }
+}
+
+Archiver::Section Archiver::ReadSection(BitReader& reader) const {
+    Section section;
+
+    section.manifest = ReadManifest(reader);
+    section.shared_tables = ReadSharedTables(reader);
+
+    return section;
+}
+
+std::vector<Archiver::Section> Archiver::ReadSections(const char* file_name,
+                                                      const ArchiveIndex& index) const {
+    BitReader reader(file_name);
+
+    std::vector<Section> sections;
+    sections.push_back(ReadSection(reader));
+
+    uint64_t end_of_previous_member = reader.BitsRead();
+
+    for (size_t member = 0; member < index.entries.size(); ++member) {
+        const ArchiveIndex::Entry& entry = index.entries[member];
+
+        if (member > 0 && entry.start_bit != end_of_previous_member) {
+            // Appended members start on the byte after ARCHIVE_END of the members before them.
+            reader.SeekToBit((end_of_previous_member + NUMBER_OF_BITS_IN_BYTE - 1) /
+                             NUMBER_OF_BITS_IN_BYTE * NUMBER_OF_BITS_IN_BYTE);
+
+            // The index before appending is skipped.
+            if (reader.Peek(ALPHABET_SIZE) != APPENDED_MEMBERS) {
+                ArchiveIndex old_index;
+                old_index.Read(reader);
+            }
+
+            if (reader.Read(ALPHABET_SIZE) != APPENDED_MEMBERS) {
+                throw std::runtime_error("error - wrong data in archive file");
+            }
+
+            sections.push_back(ReadSection(reader));
+            sections.back().first_member = member;
+
+            end_of_previous_member = reader.BitsRead();
+        }
+
+        // The members must cover the archive one after another, as if it was read from the
+        // start.
+        if (entry.start_bit != end_of_previous_member) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        end_of_previous_member = entry.start_bit + entry.compressed_bits;
+    }
+
+    return sections;
+}
+
+Manifest Archiver::ReadManifest(BitReader& reader) const {
+    Manifest manifest;
+
+    if (reader.Peek(ALPHABET_SIZE) == MANIFEST) {
+        reader.Consume(ALPHABET_SIZE);
+        reader.AlignToByte();
+
+        manifest.Read(reader);
+    }
+
+    return manifest;
+}
+
+std::vector<Huffman> Archiver::ReadSharedTables(BitReader& reader) const {
+    std::vector<Huffman> shared_tables;
+
+    while (reader.Peek(ALPHABET_SIZE) == SHARED_TABLE) {
+        reader.Consume(ALPHABET_SIZE);
+
+        if (shared_tables.size() == MAX_NUMBER_OF_SHARED_TABLES) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        size_t number_of_symbols = reader.Read(ALPHABET_SIZE);
+
+        shared_tables.emplace_back();
+        shared_tables.back().GetOrderOfSymbols(reader, number_of_symbols);
+        shared_tables.back().GetCodeOfSymbols(reader, number_of_symbols);
+    }
+
+    return shared_tables;
+}
+
+int Archiver::DecompressNextMember(BitReader& reader, ThreadPool& pool,
+                                   const std::vector<Huffman>& shared_tables,
+                                   FileStatistics& statistics) const {
+    uint64_t start_bit = reader.BitsRead();
+
+    size_t marker = reader.Read(ALPHABET_SIZE);
+    bool has_checksum = (marker == CHECKSUMMED_MEMBER || marker == CHECKSUMMED_MEMBER_WITH_NAME);
+    bool is_name_checksummed = (marker == CHECKSUMMED_MEMBER_WITH_NAME);
+
+    if (has_checksum) {
+        marker = reader.Read(ALPHABET_SIZE);
+    }
+
+    int terminator = 0;
+
+    if (marker == BLOCKED_MEMBER) {
+        terminator = DecompressNextBlockedFile(reader, pool, statistics);
+    } else if (marker == STORED_MEMBER || marker == RLE_MEMBER) {
+        terminator = DecompressNextRawFile(reader, marker, statistics);
+    } else if (marker == SHARED_TABLE_MEMBER) {
+        size_t number_of_table = reader.Read(ALPHABET_SIZE);
+
+        if (number_of_table >= shared_tables.size()) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        terminator = DecodeNextFile(reader, shared_tables[number_of_table], statistics);
+    } else {
+        terminator = DecompressNextFile(reader, marker, statistics);
+    }
+
+    uint32_t checksum = statistics.checksum;
+
+    if (is_name_checksummed) {
+        checksum = Crc32c::Extend(checksum, statistics.name.data(), statistics.name.size());
+    }
+
+    if (has_checksum && reader.Read(32) != checksum) {
+        throw std::runtime_error("error - wrong checksum of file named " + statistics.name);
+    }
+
+    statistics.archived_size = (reader.BitsRead() - start_bit + 7) / NUMBER_OF_BITS_IN_BYTE;
+    statistics.bytes_read = statistics.archived_size;
+
+    return terminator;
+}
+
+int Archiver::DecompressNextRawFile(BitReader& reader, size_t type_of_member,
+                                    FileStatistics& statistics) const {
+    statistics.name = ReadString(reader);
+
+    std::unique_ptr<BitWriter> file_writer = OpenWriterOfMember(statistics.name);
+    BitWriter& writer = *file_writer;
+
+    uint64_t size_of_file = ReadSize(reader);
+    statistics.original_size = size_of_file;
+
+    std::vector<char> buffer(std::min<uint64_t>(size_of_file, STREAMING_BLOCK_SIZE));
+
+    if (type_of_member == RLE_MEMBER) {
+        std::fill(buffer.begin(), buffer.end(),
+                  static_cast<char>(reader.Read(NUMBER_OF_BITS_IN_BYTE)));
+    }
+
+    while (size_of_file > 0) {
+        size_t size_of_chunk = std::min<uint64_t>(size_of_file, buffer.size());
+
+        if (type_of_member == STORED_MEMBER) {
+            ScopedTimer timer(statistics, FileStatistics::READ);
+            reader.ReadBytes(buffer.data(), size_of_chunk);
+        }
+
+        statistics.checksum = Crc32c::Extend(statistics.checksum, buffer.data(), size_of_chunk);
+
+        {
+            ScopedTimer timer(statistics, FileStatistics::WRITE);
+            writer.PutBytes(buffer.data(), size_of_chunk);
+        }
+
+        size_of_file -= size_of_chunk;
+    }
+
+    writer.PushTillEnd();
+
+    return static_cast<int>(reader.Read(ALPHABET_SIZE));
+}
+
+int Archiver::DecompressNextFile(BitReader& reader, size_t number_of_symbols,
+                                 FileStatistics& statistics) const {
+    Huffman huffman;
+
+    {
+        ScopedTimer timer(statistics, FileStatistics::BUILD);
+
+        huffman.GetOrderOfSymbols(reader, number_of_symbols);
+
+        huffman.GetCodeOfSymbols(reader, number_of_symbols);
+    }
+
+    return DecodeNextFile(reader, huffman, statistics);
+}
+
+int Archiver::DecodeNextFile(BitReader& reader, const Huffman& huffman,
+                             FileStatistics& statistics) const {
+    int next_value = huffman.DecodeNextSymbol(reader);
+
+    while (next_value != Huffman::FILENAME_END) {
+        statistics.name += huffman.TransformIntToChar(next_value);
+
+        next_value = huffman.DecodeNextSymbol(reader);
+    }
+
+    std::unique_ptr<BitWriter> file_writer = OpenWriterOfMember(statistics.name);
+    BitWriter& writer = *file_writer;
+
+    ScopedTimer timer(statistics, FileStatistics::DECODE);
+
+    // Bytes are decoded to a buffer, which is checksummed and written at once.
+    std::vector<char> buffer(BitReader::BUFFER_SIZE);
+    size_t size_of_buffer = 0;
+
+    next_value = huffman.DecodeNextSymbol(reader);
+
+    while (next_value != Huffman::ARCHIVE_END && next_value != Huffman::ONE_MORE_FILE) {
+        buffer[size_of_buffer++] = huffman.TransformIntToChar(next_value);
+
+        if (size_of_buffer == buffer.size()) {
+            statistics.checksum =
+                Crc32c::Extend(statistics.checksum, buffer.data(), size_of_buffer);
+            writer.PutBytes(buffer.data(), size_of_buffer);
+            size_of_buffer = 0;
+        }
+
+        next_value = huffman.DecodeNextSymbol(reader);
+    }
+
+    statistics.checksum = Crc32c::Extend(statistics.checksum, buffer.data(), size_of_buffer);
+    writer.PutBytes(buffer.data(), size_of_buffer);
+    writer.PushTillEnd();
+
+    statistics.original_size = writer.BitsWritten() / NUMBER_OF_BITS_IN_BYTE;
+
+    return next_value;
+}
+
+int Archiver::DecompressNextBlockedFile(BitReader& reader, ThreadPool& pool,
+                                        FileStatistics& statistics) const {
+    statistics.name = ReadString(reader);
+
+    std::unique_ptr<BitWriter> file_writer = OpenWriterOfMember(statistics.name);
+    BitWriter& writer = *file_writer;
+
+    const size_t number_of_blocks_in_batch = std::max<size_t>(1, 2 * pool.Size());
+
+    std::vector<std::vector<char>> compressed_blocks(number_of_blocks_in_batch);
+    std::vector<std::vector<char>> blocks(number_of_blocks_in_batch);
+
+    bool is_last_block_read = false;
+
+    while (!is_last_block_read) {
+        size_t number_of_blocks = 0;
+
+        {
+            ScopedTimer timer(statistics, FileStatistics::READ);
+
+            while (number_of_blocks < number_of_blocks_in_batch) {
+                size_t size_of_block = reader.Read(32);
+
+                if (size_of_block == 0) {
+                    is_last_block_read = true;
+                    break;
+                }
+
+                size_t size_of_compressed_block = reader.Read(32);
+
+                if (size_of_block > MAX_BLOCK_SIZE ||
+                    size_of_compressed_block > size_of_block + MAX_BLOCK_OVERHEAD) {
+                    throw std::runtime_error("error - wrong data in archive file");
+                }
+
+                compressed_blocks[number_of_blocks].resize(size_of_compressed_block);
+                reader.ReadBytes(compressed_blocks[number_of_blocks].data(),
+                                 size_of_compressed_block);
+
+                blocks[number_of_blocks].resize(size_of_block);
+                statistics.original_size += size_of_block;
+
+                ++number_of_blocks;
+            }
+        }
+
+        {
+            ScopedTimer timer(statistics, FileStatistics::DECODE);
+
+            pool.Run(number_of_blocks, [&](size_t index) {
+                DecompressBlock(compressed_blocks[index], blocks[index]);
+            });
+        }
+
+        ScopedTimer timer(statistics, FileStatistics::WRITE);
+
+        for (size_t index = 0; index < number_of_blocks; ++index) {
+            statistics.checksum =
+                Crc32c::Extend(statistics.checksum, blocks[index].data(), blocks[index].size());
+            writer.PutBytes(blocks[index].data(), blocks[index].size());
+        }
+    }
+
+    writer.PushTillEnd();
+
+    return static_cast<int>(reader.Read(ALPHABET_SIZE));
+}
+
+void Archiver::DecompressBlock(const std::vector<char>& compressed_block,
+                               std::vector<char>& block) const {
+    Huffman huffman;
+
+    DecompressBlock(compressed_block.data(), compressed_block.size(), block.data(), block.size(),
+                    huffman);
+}
+
+void Archiver::DecompressBlock(const char* compressed_block, size_t size_of_compressed_block,
+                               char* block, size_t size, Huffman& huffman) const {
+    if (size_of_compressed_block == 0) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    if ((static_cast<unsigned char>(compressed_block[0]) & CHECKSUMMED_BLOCK) == 0) {
+        DecodeBlock(compressed_block, size_of_compressed_block, block, size, huffman);
+        return;
+    }
+
+    if (size_of_compressed_block < 1 + sizeof(uint32_t)) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    size_of_compressed_block -= sizeof(uint32_t);
+
+    BitReader checksum_reader(compressed_block + size_of_compressed_block, sizeof(uint32_t));
+    uint32_t checksum = static_cast<uint32_t>(checksum_reader.Read(32));
+
+    DecodeBlock(compressed_block, size_of_compressed_block, block, size, huffman);
+
+    if (Crc32c::Extend(0, block, size) != checksum) {
+        throw std::runtime_error("error - wrong checksum of block");
+    }
+}
+
+void Archiver::DecodeBlock(const char* compressed_block, size_t size_of_compressed_block,
+                           char* block, size_t size, Huffman& huffman) const {
+    BitReader reader(compressed_block, size_of_compressed_block);
+
+    size_t type_of_block = reader.Read(NUMBER_OF_BITS_IN_BYTE) & ~CHECKSUMMED_BLOCK;
+    size_t max_code_size = Huffman::MAX_CODE_SIZE;
+
+    if (type_of_block == STORED_BLOCK) {
+        if (size_of_compressed_block != size + 1) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        std::copy(compressed_block + 1, compressed_block + size_of_compressed_block, block);
+        return;
+    }
+
+    if (type_of_block == RLE_BLOCK) {
+        if (size_of_compressed_block != 2) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        char character = static_cast<char>(reader.Read(NUMBER_OF_BITS_IN_BYTE));
+
+        std::fill(block, block + size, character);
+        return;
+    }
+
+    if (type_of_block == LZ77_BLOCK || type_of_block == LIMITED_LZ77_BLOCK) {
+        if (type_of_block == LIMITED_LZ77_BLOCK) {
+            max_code_size = ReadCodeSizeLimit(reader, DecodingTable::MAX_LOOKUP_BITS);
+        }
+
+        DecodeLz77Block(reader, block, size, max_code_size, huffman);
+        CheckEndOfBlock(reader);
+        return;
+    }
+
+    if (type_of_block == CONTEXT_HUFFMAN_BLOCK || type_of_block == LIMITED_CONTEXT_HUFFMAN_BLOCK) {
+        if (type_of_block == LIMITED_CONTEXT_HUFFMAN_BLOCK) {
+            max_code_size = ReadCodeSizeLimit(reader, DecodingTable::MAX_LOOKUP_BITS);
+        }
+
+        DecodeContextBlock(reader, block, size, max_code_size);
+        CheckEndOfBlock(reader);
+        return;
+    }
+
+    if (type_of_block == LIMITED_HUFFMAN_BLOCK) {
+        max_code_size = ReadCodeSizeLimit(reader, DecodingTable::MAX_LOOKUP_BITS);
+    } else if (type_of_block == INTERLEAVED_HUFFMAN_BLOCK) {
+        max_code_size = ReadCodeSizeLimit(reader, Huffman::MAX_CODE_SIZE);
+    } else if (type_of_block != HUFFMAN_BLOCK) {
+        throw std::runtime_error("error - unknown block type in archive file");
+    }
+
+    ReadTableOfCodes(reader, huffman, max_code_size);
+
+    if (type_of_block != INTERLEAVED_HUFFMAN_BLOCK) {
+        huffman.DecodeInterleavedStreams({&reader}, block, size);
+        CheckEndOfBlock(reader);
+        return;
+    }
+
+    reader.AlignToByte();
+
+    std::vector<size_t> sizes_of_streams(NUMBER_OF_STREAMS);
+    size_t size_of_streams = 0;
+
+    for (size_t stream = 0; stream + 1 < NUMBER_OF_STREAMS; ++stream) {
+        sizes_of_streams[stream] = reader.Read(32);
+        size_of_streams += sizes_of_streams[stream];
+    }
+
+    size_t position = reader.BytePosition();
+
+    if (position + size_of_streams > size_of_compressed_block) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    sizes_of_streams.back() = size_of_compressed_block - position - size_of_streams;
+
+    std::vector<std::unique_ptr<BitReader>> readers;
+    std::vector<BitReader*> stream_readers;
+
+    for (auto size_of_stream : sizes_of_streams) {
+        readers.push_back(
+            std::make_unique<BitReader>(compressed_block + position, size_of_stream));
+        stream_readers.push_back(readers.back().get());
+        position += size_of_stream;
+    }
+
+    huffman.DecodeInterleavedStreams(stream_readers, block, size);
+
+    for (auto stream_reader : stream_readers) {
+        CheckEndOfBlock(*stream_reader);
+    }
+}
+
+void Archiver::CheckEndOfBlock(BitReader& reader) const {
+    if (reader.Available() >= NUMBER_OF_BITS_IN_BYTE) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+}
+
+size_t Archiver::ReadCodeSizeLimit(BitReader& reader, size_t max_limit) const {
+    size_t max_code_size = reader.Read(NUMBER_OF_BITS_IN_BYTE);
+
+    if (max_code_size < Huffman::MIN_CODE_SIZE_LIMIT || max_code_size > max_limit) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    return max_code_size;
+}
+
+void Archiver::ReadTableOfCodes(BitReader& reader, Huffman& huffman,
+                                size_t max_code_size) const {
+    size_t number_of_symbols = reader.Read(ALPHABET_SIZE);
+
+    huffman.GetOrderOfSymbols(reader, number_of_symbols);
+
+    if (max_code_size <= DecodingTable::MAX_LOOKUP_BITS) {
+        huffman.GetCodeOfSymbols(reader, number_of_symbols,
+                                 std::max(max_code_size, DecodingTable::LOOKUP_BITS));
+    } else {
+        huffman.GetCodeOfSymbols(reader, number_of_symbols);
+    }
+
+    if (huffman.max_symbol_code_size > max_code_size) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+}
+
+void Archiver::DecodeLz77Block(BitReader& reader, char* block, size_t size, size_t max_code_size,
+                               Huffman& huffman) const {
+    ReadTableOfCodes(reader, huffman, max_code_size);
+
+    Huffman huffman_of_distances;
+    ReadTableOfCodes(reader, huffman_of_distances, max_code_size);
+
+    size_t position = 0;
+
+    while (true) {
+        int symbol = huffman.DecodeNextSymbol(reader);
+
+        if (symbol < Lz77::END_OF_BLOCK) {
+            if (position == size) {
+                throw std::runtime_error("error - wrong data in archive file");
+            }
+
+            block[position++] = static_cast<char>(symbol);
+            continue;
+        }
+
+        if (symbol == Lz77::END_OF_BLOCK) {
+            break;
+        }
+
+        size_t bucket = static_cast<size_t>(symbol - Lz77::FIRST_LENGTH_SYMBOL);
+
+        if (symbol < Lz77::FIRST_LENGTH_SYMBOL || bucket >= Lz77::NUMBER_OF_LENGTH_SYMBOLS) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        size_t length = Lz77::MIN_MATCH_LENGTH + Lz77::GetBaseOfBucket(bucket) +
+                        reader.Read(Lz77::GetNumberOfExtraBits(bucket));
+
+        bucket = static_cast<size_t>(huffman_of_distances.DecodeNextSymbol(reader));
+
+        if (bucket >= Lz77::NUMBER_OF_DISTANCE_SYMBOLS) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        size_t distance =
+            1 + Lz77::GetBaseOfBucket(bucket) + reader.Read(Lz77::GetNumberOfExtraBits(bucket));
+
+        if (distance > position || length > size - position) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        // The source may overlap the bytes being written, which repeats the last distance bytes.
+        if (distance >= length) {
+            std::memcpy(block + position, block + position - distance, length);
+        } else {
+            for (size_t index = 0; index < length; ++index) {
+                block[position + index] = block[position + index - distance];
+            }
+        }
+
+        position += length;
+    }
+
+    if (position != size) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+}
+
+void Archiver::DecodeContextBlock(BitReader& reader, char* block, size_t size,
+                                  size_t max_code_size) const {
+    size_t number_of_contexts_of_block = reader.Read(NUMBER_OF_BITS_IN_BYTE);
+
+    if (number_of_contexts_of_block < 1 ||
+        number_of_contexts_of_block > ContextModel::MAX_NUMBER_OF_CONTEXTS) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    const size_t bits_of_context = std::bit_width(number_of_contexts_of_block - 1);
+
+    std::vector<size_t> context_of_byte(ContextModel::NUMBER_OF_BYTES);
+
+    for (auto& context : context_of_byte) {
+        context = reader.Read(bits_of_context);
+
+        if (context >= number_of_contexts_of_block) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+    }
+
+    std::vector<Huffman> huffman_of_contexts(number_of_contexts_of_block);
+
+    for (auto& huffman : huffman_of_contexts) {
+        ReadTableOfCodes(reader, huffman, max_code_size);
+    }
+
+    // The codes up to LOOKUP_BITS long of all contexts are packed into one table, whose entries
+    // hold the byte, the length of its code and the context that the byte switches to, so that the
+    // next lookup does not wait for another load. Zero lengths mark longer codes.
+    const size_t lookup_bits = DecodingTable::LOOKUP_BITS;
+    const uint64_t lookup_mask = (static_cast<uint64_t>(1) << lookup_bits) - 1;
+    std::vector<uint32_t> entries(number_of_contexts_of_block << lookup_bits);
+
+    for (size_t context = 0; context < number_of_contexts_of_block; ++context) {
+        const auto& primary_table = huffman_of_contexts[context].decoding_table.primary_table;
+        uint32_t* entries_of_context = entries.data() + (context << lookup_bits);
+
+        for (size_t bits = 0; bits <= lookup_mask; ++bits) {
+            const DecodingTable::Entry& entry = primary_table[bits & (primary_table.size() - 1)];
+
+            if (entry.symbol >= 0 && entry.symbol < Huffman::FILENAME_END &&
+                entry.length <= lookup_bits) {
+                entries_of_context[bits] = static_cast<uint32_t>(
+                    entry.symbol | (entry.length << 8) | (context_of_byte[entry.symbol] << 16));
+            }
+        }
+    }
+
+    // As in Huffman::DecodeInterleavedStreams, the state of the reader is kept in locals and
+    // refilled for a group of bytes at once; only longer codes go back to the reader.
+    const size_t symbols_per_refill = BitReader::MAX_PEEK_BITS / lookup_bits;
+
+    const char* data = reader.data_;
+    size_t position = reader.position_;
+    const size_t end = reader.end_;
+    uint64_t bit_buffer = reader.bit_buffer_;
+    size_t bits_in_buffer = reader.bits_in_buffer_;
+
+    auto load = [&] {
+        data = reader.data_;
+        position = reader.position_;
+        bit_buffer = reader.bit_buffer_;
+        bits_in_buffer = reader.bits_in_buffer_;
+    };
+
+    auto save = [&] {
+        reader.position_ = position;
+        reader.bit_buffer_ = bit_buffer;
+        reader.bits_in_buffer_ = bits_in_buffer;
+    };
+
+    size_t context = context_of_byte[ContextModel::FIRST_PREVIOUS_BYTE];
+
+    for (size_t index = 0; index < size;) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if (position + sizeof(uint64_t) <= end && bits_in_buffer < sizeof(uint64_t) * 8) {
+            uint64_t word;
+            std::memcpy(&word, data + position, sizeof(word));
+
+            size_t number_of_bytes = (63 - bits_in_buffer) / 8;
+
+            bit_buffer |= word << bits_in_buffer;
+            bits_in_buffer += number_of_bytes * 8;
+            bit_buffer &= (static_cast<uint64_t>(1) << bits_in_buffer) - 1;
+            position += number_of_bytes;
+        } else
+#endif
+        {
+            save();
+            reader.Refill();
+            load();
+        }
+
+        size_t end_of_group = std::min(size, index + symbols_per_refill);
+
+        for (; index < end_of_group; ++index) {
+            uint32_t entry = entries[(context << lookup_bits) | (bit_buffer & lookup_mask)];
+            size_t length = (entry >> 8) & 0xFF;
+
+            if (length != 0 && length <= bits_in_buffer) {
+                block[index] = static_cast<char>(entry & 0xFF);
+                bit_buffer >>= length;
+                bits_in_buffer -= length;
+                context = entry >> 16;
+                continue;
+            }
+
+            save();
+            block[index] = huffman_of_contexts[context].DecodeNextByte(reader);
+            load();
+
+            context = context_of_byte[static_cast<unsigned char>(block[index])];
+        }
+    }
+
+    save();
+}
+
+void Archiver::Compress(const std::string& archive_name,
+                        const std::vector<std::string>& file_names) const {
+    if (file_names.empty()) {
+        throw std::runtime_error("error - too few arguments");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    const Manifest manifest = BuildManifest(file_names);
+
+    std::unique_ptr<BitWriter> archive_writer = OpenWriter(archive_name);
+    BitWriter& writer = *archive_writer;
+
+    ArchiveIndex index;
+    FileStatistics total;
+
+    PushSection(manifest, writer, index, total);
+
+    writer.PushTillEnd();
+
+    if (write_index) {
+        index.Push(writer);
+
+        writer.PushTillEnd();
+    }
+
+    PrintTotalStatistics(total, start);
+}
+
+void Archiver::Append(const std::string& archive_name,
+                      const std::vector<std::string>& file_names) const {
+    if (file_names.empty()) {
+        throw std::runtime_error("error - too few arguments");
+    }
+
+    if (archive_name == STANDARD_STREAM_NAME) {
+        throw std::runtime_error("error - cannot append to stdout");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    ArchiveIndex index;
+
+    if (!index.ReadFromEnd(archive_name.c_str())) {
+        throw std::runtime_error("error - archive has no index, use -c to compress it again");
+    }
+
+    if (index.entries.empty()) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    const Manifest manifest = BuildManifest(file_names);
+
+    const uint64_t size_of_archive = std::filesystem::file_size(archive_name);
+
+    FileStatistics total;
+
+    try {
+        BitWriter writer(archive_name, size_of_archive);
+
+        PushNumber(writer, static_cast<int>(APPENDED_MEMBERS));
+        PushSection(manifest, writer, index, total);
+
+        writer.PushTillEnd();
+
+        if (write_index) {
+            index.Push(writer);
+
+            writer.PushTillEnd();
+        }
+    } catch (...) {
+        // The writer is closed here, so the archive is cut back to its old index at the end.
+        std::filesystem::resize_file(archive_name, size_of_archive);
+        throw;
+    }
+
+    PrintTotalStatistics(total, start);
+}
+
+Manifest Archiver::BuildManifest(const std::vector<std::string>& file_names) const {
+    Manifest manifest;
+
+    for (const auto& file_name : file_names) {
+        if (file_name == STANDARD_STREAM_NAME) {
+            manifest.entries.push_back({file_name});
+        } else {
+            manifest.Add(file_name);
+        }
+    }
+
+    if (manifest.GetFileNames().empty()) {
+        throw std::runtime_error("error - no files to archive");
+    }
+
+    return manifest;
+}
+
+void Archiver::PushSection(const Manifest& manifest, BitWriter& writer, ArchiveIndex& index,
+                           FileStatistics& total) const {
+    const std::vector<std::string> names_of_files = manifest.GetFileNames();
+
+    if (write_manifest) {
+        PushNumber(writer, static_cast<int>(MANIFEST));
+        writer.PushTillEnd();
+
+        manifest.Push(writer);
+    }
+
+    std::vector<Huffman> shared_tables = BuildSharedTables(names_of_files);
+
+    // All bytes and service symbols have codes in a shared table.
+    for (const auto& huffman : shared_tables) {
+        PushNumber(writer, static_cast<int>(SHARED_TABLE));
+        PushTableOfCodes(writer, huffman, ARCHIVE_END + 1);
+    }
+
+    if (number_of_threads > 1 && names_of_files.size() > 1) {
+        CompressInParallel(names_of_files, shared_tables, writer, index, total);
+    } else {
+        std::vector<char> file_buffer;
+
+        ThreadPool pool(number_of_threads > 1 ? number_of_threads : 0);
+
+        for (size_t file_index = 0; file_index < names_of_files.size(); ++file_index) {
+            size_t start_bit = writer.BitsWritten();
+
+            FileStatistics statistics =
+                CompressNextFile(names_of_files[file_index], shared_tables, writer, file_buffer,
+                                 pool, file_index + 1 == names_of_files.size());
+
+            AddFileToIndex(index, names_of_files[file_index], start_bit, writer, statistics,
+                           total);
+        }
+    }
+}
+
+void Archiver::AddFileToIndex(ArchiveIndex& index, const std::string& file_name,
+                              size_t start_bit, const BitWriter& writer,
+                              FileStatistics& statistics, FileStatistics& total) const {
+    ArchiveIndex::Entry entry;
+
+    entry.name = Manifest::GetNameInArchive(file_name);
+    entry.start_bit = start_bit;
+    entry.original_size = statistics.original_size;
+    entry.compressed_bits = writer.BitsWritten() - start_bit;
+
+    statistics.name = file_name;
+    statistics.archived_size =
+        (entry.compressed_bits + NUMBER_OF_BITS_IN_BYTE - 1) / NUMBER_OF_BITS_IN_BYTE;
+
+    index.entries.push_back(std::move(entry));
+
+    AddFileToStatistics(total, statistics);
+}
+
+void Archiver::AddFileToStatistics(FileStatistics& total, const FileStatistics& statistics) const {
+    if (!print_statistics) {
+        return;
+    }
+
+    statistics.Print(std::cerr, statistics.GetSeconds());
+
+    total.Add(statistics);
+}
+
+void Archiver::PrintTotalStatistics(const FileStatistics& total,
+                                    std::chrono::steady_clock::time_point start) const {
+    if (!print_statistics) {
+        return;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    FileStatistics total_with_name = total;
+    total_with_name.name = "total";
+    total_with_name.Print(std::cerr, elapsed.count());
+
+    std::cerr << "peak RSS: " << (FileStatistics::GetPeakResidentSetSize() >> 10) << " KiB\n";
+}
+
+void Archiver::CompressInParallel(const std::vector<std::string>& file_names,
+                                  const std::vector<Huffman>& shared_tables, BitWriter& writer,
+                                  ArchiveIndex& index, FileStatistics& total) const {
+    const size_t number_of_files = file_names.size();
+    const size_t max_files_in_flight = 2 * number_of_threads;
+
+    std::vector<std::unique_ptr<BitWriter>> compressed_files(number_of_files);
+    std::vector<FileStatistics> statistics(number_of_files);
+    std::vector<std::exception_ptr> errors(number_of_files);
+    std::vector<bool> is_ready(number_of_files);
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t next_file_to_compress = 0;
+    size_t next_file_to_write = 0;
+    bool is_stopped = false;
+
+    auto worker = [&]() {
+        std::vector<char> file_buffer;
+
+        ThreadPool serial_pool(0);
+
+        while (true) {
+            size_t index = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                condition.wait(lock, [&]() {
+                    return is_stopped || next_file_to_compress == number_of_files ||
+                           next_file_to_compress < next_file_to_write + max_files_in_flight;
+                });
+
+                if (is_stopped || next_file_to_compress == number_of_files) {
+                    return;
+                }
+
+                index = next_file_to_compress++;
+            }
+
+            std::unique_ptr<BitWriter> compressed_file;
+            FileStatistics statistics_of_file;
+            std::exception_ptr error;
+
+            try {
+                // Large files and stdin are left to be streamed to the archive, so that at most
+                // max_files_in_flight buffered files are held in memory.
+                if (file_names[index] != STANDARD_STREAM_NAME &&
+                    GetSizeOfFile(file_names[index]) <= max_buffered_file_size) {
+                    compressed_file = std::make_unique<BitWriter>();
+
+                    statistics_of_file =
+                        CompressNextFile(file_names[index], shared_tables, *compressed_file,
+                                         file_buffer, serial_pool, index + 1 == number_of_files);
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                compressed_files[index] = std::move(compressed_file);
+                statistics[index] = statistics_of_file;
+                errors[index] = error;
+                is_ready[index] = true;
+            }
+
+            condition.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (size_t index = 0; index < std::min(number_of_threads, number_of_files); ++index) {
+        workers.emplace_back(worker);
+    }
+
+    std::exception_ptr error;
+
+    std::vector<char> file_buffer;
+
+    // Streamed files are coded here, their blocks on all threads.
+    ThreadPool pool(number_of_threads);
+
+    for (size_t file_index = 0; file_index < number_of_files && !error; ++file_index) {
+        std::unique_ptr<BitWriter> compressed_file;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            condition.wait(lock, [&]() { return static_cast<bool>(is_ready[file_index]); });
+
+            compressed_file = std::move(compressed_files[file_index]);
+            error = errors[file_index];
+        }
+
+        if (!error) {
+            size_t start_bit = writer.BitsWritten();
+
+            try {
+                if (compressed_file == nullptr) {
+                    statistics[file_index] =
+                        CompressNextFile(file_names[file_index], shared_tables, writer,
+                                         file_buffer, pool, file_index + 1 == number_of_files);
+                } else {
+                    writer.Append(*compressed_file);
+                }
+
+                AddFileToIndex(index, file_names[file_index], start_bit, writer,
+                               statistics[file_index], total);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            next_file_to_write = file_index + 1;
+            is_stopped = static_cast<bool>(error);
+        }
+
+        condition.notify_all();
+    }
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+FileStatistics Archiver::CompressNextFile(const std::string& next_file_name,
+                                          const std::vector<Huffman>& shared_tables,
+                                          BitWriter& writer, std::vector<char>& file_buffer,
+                                          ThreadPool& pool, bool is_last_file) const {
+    if (write_checksums) {
+        PushNumber(writer, static_cast<int>(CHECKSUMMED_MEMBER_WITH_NAME));
+    }
+
+    FileStatistics statistics =
+        CompressNextMember(next_file_name, shared_tables, writer, file_buffer, pool, is_last_file);
+
+    if (write_checksums) {
+        std::string name_in_archive = Manifest::GetNameInArchive(next_file_name);
+
+        writer.Put(Crc32c::Extend(statistics.checksum, name_in_archive.data(),
+                                  name_in_archive.size()),
+                   32);
+    }
+
+    return statistics;
+}
+
+FileStatistics Archiver::CompressNextMember(const std::string& next_file_name,
+                                            const std::vector<Huffman>& shared_tables,
+                                            BitWriter& writer, std::vector<char>& file_buffer,
+                                            ThreadPool& pool, bool is_last_file) const {
+    if (IsEveryFileBlocked() || next_file_name == STANDARD_STREAM_NAME) {
+        return CompressNextBlockedFile(next_file_name, writer, pool, is_last_file);
+    }
+
+    std::vector<int> file_name =
+        TransformStringToNumbers(Manifest::GetNameInArchive(next_file_name));
+
+    if (GetSizeOfFile(next_file_name) > max_buffered_file_size) {
+        return CompressNextLargeFile(next_file_name, writer, file_name, is_last_file);
+    }
+
+    FileStatistics statistics;
+    statistics.is_timed = print_statistics;
+
+    {
+        ScopedTimer timer(statistics, FileStatistics::READ);
+        ReadWholeFile(next_file_name, file_buffer);
+    }
+
+    statistics.original_size = file_buffer.size();
+    statistics.bytes_read = file_buffer.size();
+
+    std::vector<size_t> frequencies_of_bytes;
+    std::vector<size_t> frequencies_of_symbols;
+
+    {
+        ScopedTimer timer(statistics, FileStatistics::COUNT);
+
+        frequencies_of_bytes =
+            GetFrequenciesOfBytes(file_buffer.data(), file_buffer.size(), statistics.checksum);
+        frequencies_of_symbols = GetFrequenciesOfSymbols(frequencies_of_bytes, file_name);
+    }
+
+    ScopedTimer build_timer(statistics, FileStatistics::BUILD);
+
+    // With shared tables no table is built for the file, the one coding it shortest is taken.
+    Huffman huffman_of_file;
+    size_t number_of_table = 0;
+    size_t size_of_huffman_member = 0;
+
+    if (shared_tables.empty()) {
+        huffman_of_file.Build(frequencies_of_symbols);
+        size_of_huffman_member = GetSizeOfHuffmanCode(frequencies_of_symbols, huffman_of_file);
+    } else {
+        number_of_table = ChooseSharedTable(frequencies_of_symbols, shared_tables);
+        size_of_huffman_member =
+            2 * ALPHABET_SIZE +
+            GetSizeOfCodedSymbols(frequencies_of_symbols, shared_tables[number_of_table]);
+    }
+
+    const Huffman& huffman =
+        shared_tables.empty() ? huffman_of_file : shared_tables[number_of_table];
+
+    size_t type_of_member =
+        ChooseTypeOfMember(frequencies_of_bytes, size_of_huffman_member, next_file_name);
+
+    build_timer.Stop();
+
+    ScopedTimer timer(statistics, FileStatistics::ENCODE);
+
+    if (type_of_member == HUFFMAN_MEMBER) {
+        if (shared_tables.empty()) {
+            PushHeaderOfNextFile(writer, huffman, GetNumberOfSymbols(frequencies_of_symbols),
+                                 file_name);
+        } else {
+            PushNumber(writer, static_cast<int>(SHARED_TABLE_MEMBER));
+            PushNumber(writer, static_cast<int>(number_of_table));
+            PushCodedName(writer, huffman, file_name);
+        }
+
+        for (auto character : file_buffer) {
+            PushCode(writer, huffman.code_of_symbol[static_cast<unsigned char>(character)]);
+        }
+
+        PushCode(writer, huffman.code_of_symbol[is_last_file ? ARCHIVE_END : ONE_MORE_FILE]);
+    } else {
+        PushHeaderOfRawFile(writer, type_of_member, next_file_name, file_buffer.size());
+
+        if (type_of_member == STORED_MEMBER) {
+            writer.PutBytes(file_buffer.data(), file_buffer.size());
+        } else {
+            writer.Put(GetMostFrequentByte(frequencies_of_bytes), NUMBER_OF_BITS_IN_BYTE);
+        }
+
+        PushNumber(writer, static_cast<int>(is_last_file ? ARCHIVE_END : ONE_MORE_FILE));
+    }
+
+    timer.Stop();
+
+    return statistics;
+}
+
+bool Archiver::IsEveryFileBlocked() const {
+    return block_size > 0 || code_size_limit > 0 || interleave_streams || lz77_level > 0 ||
+           number_of_contexts > 0;
+}
+
+FileStatistics Archiver::CompressNextLargeFile(const std::string& next_file_name,
+                                               BitWriter& writer,
+                                               const std::vector<int>& file_name,
+                                               bool is_last_file) const {
+    FileStatistics statistics;
+    statistics.is_timed = print_statistics;
+
+    ScopedTimer count_timer(statistics, FileStatistics::COUNT);
+
+    BitReader reader_to_count_frequencies(next_file_name.c_str());
+
+    std::vector<size_t> frequencies_of_bytes =
+        GetFrequenciesOfBytes(reader_to_count_frequencies, statistics.checksum);
+    std::vector<size_t> frequencies_of_symbols =
+        GetFrequenciesOfSymbols(frequencies_of_bytes, file_name);
+
+    count_timer.Stop();
+
+    ScopedTimer build_timer(statistics, FileStatistics::BUILD);
+
+    Huffman huffman(frequencies_of_symbols);
+
+    size_t type_of_member = ChooseTypeOfMember(
+        frequencies_of_bytes, GetSizeOfHuffmanCode(frequencies_of_symbols, huffman),
+        next_file_name);
+
+    build_timer.Stop();
+
+    statistics.original_size = reader_to_count_frequencies.bytes_read_;
+    statistics.bytes_read = reader_to_count_frequencies.bytes_read_;
+
+    // The second pass reads the file again, so its time is in ENCODE.
+    ScopedTimer timer(statistics, FileStatistics::ENCODE);
+
+    if (type_of_member == RLE_MEMBER) {
+        PushHeaderOfRawFile(writer, type_of_member, next_file_name, statistics.original_size);
+        writer.Put(GetMostFrequentByte(frequencies_of_bytes), NUMBER_OF_BITS_IN_BYTE);
+        PushNumber(writer, static_cast<int>(is_last_file ? ARCHIVE_END : ONE_MORE_FILE));
+
+        timer.Stop();
+
+        return statistics;
+    }
+
+    BitReader reader(next_file_name.c_str());
+
+    if (type_of_member == STORED_MEMBER) {
+        PushHeaderOfRawFile(writer, type_of_member, next_file_name, statistics.original_size);
+
+        while (reader.ReadNextChunk()) {
+            writer.PutBytes(reader.data_, reader.end_);
+        }
+
+        if (reader.bytes_read_ != statistics.original_size) {
+            throw std::runtime_error("error - file named " + next_file_name +
+                                     " changed while read");
+        }
+
+        PushNumber(writer, static_cast<int>(is_last_file ? ARCHIVE_END : ONE_MORE_FILE));
+    } else {
+        PushHeaderOfNextFile(writer, huffman, GetNumberOfSymbols(frequencies_of_symbols),
+                             file_name);
+
+        while (!reader.IsEnd()) {
+            PushCode(writer, huffman.code_of_symbol[reader.Read(NUMBER_OF_BITS_IN_BYTE)]);
+        }
+
+        PushCode(writer, huffman.code_of_symbol[is_last_file ? ARCHIVE_END : ONE_MORE_FILE]);
+    }
+
+    statistics.original_size = reader.bytes_read_;
+    statistics.bytes_read += reader.bytes_read_;
+
+    timer.Stop();
+
+    return statistics;
+}
+
+FileStatistics Archiver::CompressNextBlockedFile(const std::string& next_file_name,
+                                                 BitWriter& writer, ThreadPool& pool,
+                                                 bool is_last_file) const {
+    std::unique_ptr<BitReader> file_reader = OpenReader(next_file_name);
+
+    const size_t size_of_block = (block_size > 0 ? block_size : STREAMING_BLOCK_SIZE);
+
+    PushNumber(writer, static_cast<int>(BLOCKED_MEMBER));
+
+    PushString(writer, Manifest::GetNameInArchive(next_file_name));
+
+    const size_t number_of_blocks_in_batch = std::max<size_t>(1, 2 * pool.Size());
+
+    std::vector<std::vector<char>> blocks(number_of_blocks_in_batch);
+    std::vector<std::vector<char>> compressed_blocks(number_of_blocks_in_batch);
+
+    FileStatistics statistics;
+    statistics.is_timed = print_statistics;
+
+    bool is_end_of_file = false;
+
+    while (!is_end_of_file) {
+        size_t number_of_blocks = 0;
+
+        ScopedTimer read_timer(statistics, FileStatistics::READ);
+
+        while (number_of_blocks < number_of_blocks_in_batch && !is_end_of_file) {
+            std::vector<char>& block = blocks[number_of_blocks];
+
+            block.resize(size_of_block);
+            block.resize(file_reader->ReadSomeBytes(block.data(), size_of_block));
+
+            statistics.original_size += block.size();
+            statistics.checksum = Crc32c::Extend(statistics.checksum, block.data(), block.size());
+            is_end_of_file = block.size() < size_of_block;
+
+            if (!block.empty()) {
+                ++number_of_blocks;
+            }
+        }
+
+        read_timer.Stop();
+
+        // Blocks are counted, built and encoded together on the pool, so all of it is ENCODE.
+        {
+            ScopedTimer timer(statistics, FileStatistics::ENCODE);
+
+            pool.Run(number_of_blocks, [&](size_t index) {
+                CompressBlock(blocks[index].data(), blocks[index].size(),
+                              compressed_blocks[index]);
+            });
+        }
+
+        ScopedTimer timer(statistics, FileStatistics::WRITE);
+
+        for (size_t index = 0; index < number_of_blocks; ++index) {
+            writer.Put(blocks[index].size(), 32);
+            writer.Put(compressed_blocks[index].size(), 32);
+            writer.PutBytes(compressed_blocks[index].data(), compressed_blocks[index].size());
+        }
+    }
+
+    writer.Put(0, 32);
+
+    PushNumber(writer, static_cast<int>(is_last_file ? ARCHIVE_END : ONE_MORE_FILE));
+
+    statistics.bytes_read = statistics.original_size;
+
+    return statistics;
 }
 
-void Archiver::Compress(int argc, char* argv[]) const {
-    if (argc <= 3) {
-        throw std::runtime_error("error - too few arguments");
+void Archiver::CompressBlock(const char* block, size_t size,
+                             std::vector<char>& compressed_block) const {
+    Huffman huffman;
+
+    CompressBlock(block, size, compressed_block, huffman);
+}
+
+void Archiver::CompressBlock(const char* block, size_t size, std::vector<char>& compressed_block,
+                             Huffman& huffman) const {
+    uint32_t checksum = 0;
+    std::vector<size_t> frequencies_of_symbols;
+
+    if (block_checksums) {
+        frequencies_of_symbols = GetFrequenciesOfBytes(block, size, checksum);
+    } else {
+        frequencies_of_symbols = GetFrequenciesOfBytes(block, size);
+    }
+
+    EncodeBlock(block, size, frequencies_of_symbols, compressed_block, huffman);
+
+    if (block_checksums) {
+        compressed_block[0] = static_cast<char>(compressed_block[0] | CHECKSUMMED_BLOCK);
+
+        for (size_t index = 0; index < sizeof(checksum); ++index) {
+            compressed_block.push_back(static_cast<char>(checksum >> (index * 8)));
+        }
+    }
+}
+
+void Archiver::EncodeBlock(const char* block, size_t size,
+                           const std::vector<size_t>& frequencies_of_symbols,
+                           std::vector<char>& compressed_block, Huffman& huffman) const {
+    BitWriter writer;
+
+    if (GetNumberOfSymbols(frequencies_of_symbols) < 2) {
+        writer.Put(RLE_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+        writer.Put(GetMostFrequentByte(frequencies_of_symbols), NUMBER_OF_BITS_IN_BYTE);
+        writer.PushTillEnd();
+
+        compressed_block = std::move(writer.buffer_);
+        return;
     }
 
-    Writer writer(argv[2]);
+    compressed_block.clear();
 
-    std::deque<bool>& bits_to_push_in_archive = writer.bits_to_push_;
+    if (lz77_level > 0) {
+        EncodeLz77Block(block, size, compressed_block, huffman);
+    }
+
+    if (number_of_contexts > 0 && size >= ContextModel::MIN_SIZE_OF_BLOCK) {
+        std::vector<char> context_block;
+        EncodeContextBlock(block, size, context_block);
+
+        if (compressed_block.empty() || context_block.size() < compressed_block.size()) {
+            compressed_block = std::move(context_block);
+        }
+    }
+
+    size_t max_code_size = code_size_limit > 0 ? code_size_limit : Huffman::MAX_CODE_SIZE;
+
+    if (!compressed_block.empty()) {
+        // Blocks with few repeated strings or contexts alike are shorter, or stored, with one
+        // table.
+        huffman.Build(frequencies_of_symbols, max_code_size);
+
+        if (compressed_block.size() * NUMBER_OF_BITS_IN_BYTE <
+            std::min(NUMBER_OF_BITS_IN_BYTE + GetSizeOfHuffmanCode(frequencies_of_symbols, huffman),
+                     size * NUMBER_OF_BITS_IN_BYTE)) {
+            return;
+        }
+    }
+
+    if (interleave_streams) {
+        writer.Put(INTERLEAVED_HUFFMAN_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+        writer.Put(max_code_size, NUMBER_OF_BITS_IN_BYTE);
+    } else if (code_size_limit > 0) {
+        writer.Put(LIMITED_HUFFMAN_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+        writer.Put(code_size_limit, NUMBER_OF_BITS_IN_BYTE);
+    } else {
+        writer.Put(HUFFMAN_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+    }
 
-    for (size_t index = 3; index < static_cast<size_t>(argc); ++index) {
-        char* next_file_name = argv[index];
+    huffman.Build(frequencies_of_symbols, max_code_size);
 
-        Reader reader_to_count_frequencies(next_file_name);
+    size_t size_of_padding = 0;
+
+    if (interleave_streams) {
+        // The streams start at a byte, after the sizes of all but the last, and each ends at one.
+        size_of_padding = (NUMBER_OF_BITS_IN_BYTE - 1) + (NUMBER_OF_STREAMS - 1) * 32 +
+                          NUMBER_OF_STREAMS * (NUMBER_OF_BITS_IN_BYTE - 1);
+    }
+
+    if (writer.BitsWritten() + size_of_padding +
+            GetSizeOfHuffmanCode(frequencies_of_symbols, huffman) >=
+        (size + 1) * NUMBER_OF_BITS_IN_BYTE) {
+        compressed_block.assign(1, static_cast<char>(STORED_BLOCK));
+        compressed_block.insert(compressed_block.end(), block, block + size);
+        return;
+    }
 
-        std::string next_file_name_str = static_cast<std::string>(next_file_name);
-        std::vector<int> file_name = TransformStringToNumbers(next_file_name_str);
+    PushTableOfCodes(writer, huffman, GetNumberOfSymbols(frequencies_of_symbols));
 
-        CompressNextFile(next_file_name, writer, bits_to_push_in_archive,
-                         reader_to_count_frequencies, next_file_name_str, file_name, index, argc);
+    if (interleave_streams) {
+        PushInterleavedStreams(writer, huffman, block, size);
+    } else {
+        for (size_t index = 0; index < size; ++index) {
+            PushCode(writer, huffman.code_of_symbol[static_cast<unsigned char>(block[index])]);
+        }
     }
 
     writer.PushTillEnd();
+
+    compressed_block = std::move(writer.buffer_);
 }
 
-void Archiver::CompressNextFile(char* next_file_name, Writer& writer,
-                                std::deque<bool>& bits_to_push_in_archive,
-                                Reader& reader_to_count_frequencies,
-                                const std::string& next_file_name_str,
-                                const std::vector<int>& file_name, size_t index, int argc) const {
-    std::vector<size_t> frequencies_of_symbols =
-        GetFrequenciesOfSymbols(reader_to_count_frequencies);
+void Archiver::EncodeLz77Block(const char* block, size_t size,
+                               std::vector<char>& compressed_block, Huffman& huffman) const {
+    Lz77 lz77(lz77_level);
+    std::vector<Lz77::Token> tokens;
 
-    for (auto symbol : file_name) {
-        frequencies_of_symbols[symbol]++;
-    }
+    lz77.FindMatches(block, size, tokens);
+
+    std::vector<size_t> frequencies_of_symbols(SYMBOLS_COUNT);
+    std::vector<size_t> frequencies_of_distances(SYMBOLS_COUNT);
 
-    size_t number_of_symbols = GetNumberOfSymbols(frequencies_of_symbols);
+    frequencies_of_symbols[Lz77::END_OF_BLOCK] = 1;
 
-    for (size_t counter = 0; counter < ALPHABET_SIZE; ++counter) {
-        if ((number_of_symbols >> counter) & 1) {
-            bits_to_push_in_archive.push_back(true);
+    for (const auto& token : tokens) {
+        if (token.length == 0) {
+            ++frequencies_of_symbols[token.value];
         } else {
-            bits_to_push_in_archive.push_back(false);
+            ++frequencies_of_symbols[Lz77::FIRST_LENGTH_SYMBOL +
+                                     Lz77::GetBucket(token.length - Lz77::MIN_MATCH_LENGTH)];
+            ++frequencies_of_distances[Lz77::GetBucket(token.value - 1)];
         }
+    }
 
-        writer.PushTillCan();
+    // A table of codes has at least two symbols.
+    if (GetNumberOfSymbols(frequencies_of_distances) < 2) {
+        ++frequencies_of_distances[0];
+        ++frequencies_of_distances[1];
     }
 
-    Huffman huffman(frequencies_of_symbols);
+    const size_t max_code_size = code_size_limit > 0 ? code_size_limit : Huffman::MAX_CODE_SIZE;
+
+    huffman.Build(frequencies_of_symbols, max_code_size);
+    Huffman huffman_of_distances(frequencies_of_distances, max_code_size);
+
+    BitWriter writer;
+
+    if (code_size_limit > 0) {
+        writer.Put(LIMITED_LZ77_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+        writer.Put(code_size_limit, NUMBER_OF_BITS_IN_BYTE);
+    } else {
+        writer.Put(LZ77_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+    }
+
+    PushTableOfCodes(writer, huffman, GetNumberOfSymbols(frequencies_of_symbols));
+    PushTableOfCodes(writer, huffman_of_distances, GetNumberOfSymbols(frequencies_of_distances));
+
+    for (const auto& token : tokens) {
+        if (token.length == 0) {
+            PushCode(writer, huffman.code_of_symbol[token.value]);
+            continue;
+        }
+
+        uint32_t length = token.length - static_cast<uint32_t>(Lz77::MIN_MATCH_LENGTH);
+        size_t bucket = Lz77::GetBucket(length);
+
+        PushCode(writer, huffman.code_of_symbol[Lz77::FIRST_LENGTH_SYMBOL + bucket]);
+        writer.Put(length - Lz77::GetBaseOfBucket(bucket), Lz77::GetNumberOfExtraBits(bucket));
+
+        uint32_t distance = token.value - 1;
+        bucket = Lz77::GetBucket(distance);
+
+        PushCode(writer, huffman_of_distances.code_of_symbol[bucket]);
+        writer.Put(distance - Lz77::GetBaseOfBucket(bucket), Lz77::GetNumberOfExtraBits(bucket));
+    }
+
+    PushCode(writer, huffman.code_of_symbol[Lz77::END_OF_BLOCK]);
+
+    writer.PushTillEnd();
+
+    compressed_block = std::move(writer.buffer_);
+}
+
+void Archiver::EncodeContextBlock(const char* block, size_t size,
+                                  std::vector<char>& compressed_block) const {
+    ContextModel context_model(number_of_contexts);
+    context_model.Build(block, size);
+
+    const size_t number_of_contexts_of_block = context_model.frequencies_of_contexts.size();
+
+    const size_t max_code_size = code_size_limit > 0 ? code_size_limit : Huffman::MAX_CODE_SIZE;
+
+    std::vector<Huffman> huffman_of_contexts;
+
+    for (const auto& frequencies : context_model.frequencies_of_contexts) {
+        huffman_of_contexts.emplace_back(frequencies, max_code_size);
+    }
+
+    BitWriter writer;
+
+    if (code_size_limit > 0) {
+        writer.Put(LIMITED_CONTEXT_HUFFMAN_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+        writer.Put(code_size_limit, NUMBER_OF_BITS_IN_BYTE);
+    } else {
+        writer.Put(CONTEXT_HUFFMAN_BLOCK, NUMBER_OF_BITS_IN_BYTE);
+    }
+    writer.Put(number_of_contexts_of_block, NUMBER_OF_BITS_IN_BYTE);
+
+    const size_t bits_of_context = std::bit_width(number_of_contexts_of_block - 1);
+
+    for (auto context : context_model.context_of_byte) {
+        writer.Put(context, bits_of_context);
+    }
+
+    for (size_t context = 0; context < number_of_contexts_of_block; ++context) {
+        PushTableOfCodes(writer, huffman_of_contexts[context],
+                         GetNumberOfSymbols(context_model.frequencies_of_contexts[context]));
+    }
+
+    unsigned char previous_byte = ContextModel::FIRST_PREVIOUS_BYTE;
+
+    for (size_t index = 0; index < size; ++index) {
+        unsigned char byte = static_cast<unsigned char>(block[index]);
+
+        const Huffman& huffman = huffman_of_contexts[context_model.context_of_byte[previous_byte]];
+
+        PushCode(writer, huffman.code_of_symbol[byte]);
+        previous_byte = byte;
+    }
+
+    writer.PushTillEnd();
+
+    compressed_block = std::move(writer.buffer_);
+}
+
+void Archiver::PushInterleavedStreams(BitWriter& writer, const Huffman& huffman,
+                                      const char* block, size_t size) const {
+    const size_t size_of_part = (size + NUMBER_OF_STREAMS - 1) / NUMBER_OF_STREAMS;
+
+    std::vector<std::vector<char>> streams(NUMBER_OF_STREAMS);
+
+    for (size_t stream = 0; stream < NUMBER_OF_STREAMS; ++stream) {
+        size_t begin = std::min(size, stream * size_of_part);
+        size_t end = std::min(size, begin + size_of_part);
+
+        BitWriter stream_writer;
+
+        for (size_t index = begin; index < end; ++index) {
+            unsigned char symbol = static_cast<unsigned char>(block[index]);
+            PushCode(stream_writer, huffman.code_of_symbol[symbol]);
+        }
+
+        stream_writer.PushTillEnd();
+        streams[stream] = std::move(stream_writer.buffer_);
+    }
+
+    writer.PushTillEnd();
+
+    for (size_t stream = 0; stream + 1 < NUMBER_OF_STREAMS; ++stream) {
+        writer.Put(streams[stream].size(), 32);
+    }
+
+    for (const auto& stream : streams) {
+        writer.PutBytes(stream.data(), stream.size());
+    }
+}
+
+void Archiver::PushHeaderOfNextFile(BitWriter& writer, const Huffman& huffman,
+                                    size_t number_of_symbols,
+                                    const std::vector<int>& file_name) const {
+    PushTableOfCodes(writer, huffman, number_of_symbols);
+
+    PushCodedName(writer, huffman, file_name);
+}
+
+void Archiver::PushCodedName(BitWriter& writer, const Huffman& huffman,
+                             const std::vector<int>& file_name) const {
+    for (auto value : file_name) {
+        PushCode(writer, huffman.code_of_symbol[value]);
+    }
+
+    PushCode(writer, huffman.code_of_symbol[FILENAME_END]);
+}
+
+void Archiver::PushTableOfCodes(BitWriter& writer, const Huffman& huffman,
+                                size_t number_of_symbols) const {
+    PushNumber(writer, static_cast<int>(number_of_symbols));
 
     for (size_t next_index = 0; next_index < number_of_symbols; next_index++) {
-        PushNumberToDequeBool(writer, bits_to_push_in_archive,
-                              huffman.order_of_symbols[next_index]);
+        PushNumber(writer, huffman.order_of_symbols[next_index]);
     }
 
     for (size_t current_index = 1; current_index < huffman.number_of_codes_with_size.size();
          current_index++) {
-        PushNumberToDequeBool(writer, bits_to_push_in_archive,
-                              huffman.number_of_codes_with_size[current_index]);
+        PushNumber(writer, huffman.number_of_codes_with_size[current_index]);
     }
+}
 
-    for (auto value : file_name) {
-        AppearVectorBoolToDequeBool(writer, bits_to_push_in_archive, huffman.code_of_symbol[value]);
+void Archiver::PushHeaderOfRawFile(BitWriter& writer, size_t type_of_member,
+                                   const std::string& next_file_name, uint64_t size) const {
+    PushNumber(writer, static_cast<int>(type_of_member));
+
+    PushString(writer, Manifest::GetNameInArchive(next_file_name));
+
+    PushSize(writer, size);
+}
+
+void Archiver::PushSize(BitWriter& writer, uint64_t size) const {
+    writer.Put(size & 0xFFFFFFFF, 32);
+    writer.Put(size >> 32, 32);
+}
+
+uint64_t Archiver::ReadSize(BitReader& reader) const {
+    uint64_t lower_half = reader.Read(32);
+
+    return lower_half | (reader.Read(32) << 32);
+}
+
+void Archiver::PushString(BitWriter& writer, const std::string& str) const {
+    writer.Put(str.size(), 32);
+    writer.PutBytes(str.data(), str.size());
+}
+
+std::string Archiver::ReadString(BitReader& reader) const {
+    std::string str(reader.Read(32), '\0');
+
+    if (str.size() > MAX_BLOCK_SIZE) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    reader.ReadBytes(str.data(), str.size());
+
+    return str;
+}
+
+std::unique_ptr<BitReader> Archiver::OpenReader(const std::string& file_name) const {
+    if (file_name == STANDARD_STREAM_NAME) {
+        return std::make_unique<BitReader>(std::cin);
+    }
+
+    return std::make_unique<BitReader>(file_name.c_str());
+}
+
+std::unique_ptr<BitWriter> Archiver::OpenWriterOfMember(const std::string& name) const {
+    if (name != STANDARD_STREAM_NAME && !Manifest::IsSafePath(name)) {
+        throw std::runtime_error("error - unsafe path " + name + " in archive");
+    }
+
+    return OpenWriter(name);
+}
+
+std::unique_ptr<BitWriter> Archiver::OpenWriter(const std::string& file_name) const {
+    if (file_name == STANDARD_STREAM_NAME) {
+        return std::make_unique<BitWriter>(std::cout);
+    }
+
+    try {
+        return std::make_unique<BitWriter>(file_name);
+    } catch (const std::runtime_error&) {
+        // The directories of archives without a manifest are created when their first file is.
+        std::filesystem::path parent = std::filesystem::path(file_name).parent_path();
+
+        if (parent.empty() || !std::filesystem::create_directories(parent)) {
+            throw;
+        }
     }
 
-    AppearVectorBoolToDequeBool(writer, bits_to_push_in_archive,
-                                huffman.code_of_symbol[FILENAME_END]);
+    return std::make_unique<BitWriter>(file_name);
+}
 
-    Reader reader(next_file_name);
+size_t Archiver::GetSizeOfFile(const std::string& file_name) const {
+    std::ifstream in(file_name, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
 
-    while (!reader.bits_of_file_.empty()) {
-        reader.ReadNextBits();
+    if (!in.is_open()) {
+        throw std::runtime_error("error - cannot open file named " + file_name);
+    }
 
-        int value = reader.GetValueOfNextBits(NUMBER_OF_BITS_IN_BYTE);
+    return static_cast<size_t>(in.tellg());
+}
 
-        AppearVectorBoolToDequeBool(writer, bits_to_push_in_archive, huffman.code_of_symbol[value]);
+void Archiver::ReadWholeFile(const std::string& file_name, std::vector<char>& file_buffer) const {
+    std::ifstream in(file_name, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
 
-        reader.DeleteUselessBitsAtTheBeginning(NUMBER_OF_BITS_IN_BYTE);
+    if (!in.is_open()) {
+        throw std::runtime_error("error - cannot open file named " + file_name);
     }
 
-    AppearVectorBoolToDequeBool(
-        writer, bits_to_push_in_archive,
-        huffman.code_of_symbol[(index + 1 == static_cast<size_t>(argc) ? ARCHIVE_END
-                                                                       : ONE_MORE_FILE)]);
+    file_buffer.resize(static_cast<size_t>(in.tellg()));
+
+    in.seekg(0);
+    in.read(file_buffer.data(), static_cast<std::streamsize>(file_buffer.size()));
+
+    file_buffer.resize(static_cast<size_t>(in.gcount()));
+}
+
+std::vector<size_t> Archiver::GetFrequenciesOfSymbols(
+    const std::vector<size_t>& frequencies_of_bytes, const std::vector<int>& file_name) const {
+    std::vector<size_t> frequencies_of_symbols = frequencies_of_bytes;
 
-    writer.PushTillCan();
+    std::vector<size_t> frequencies_of_service_symbols = GetFrequenciesOfServiceSymbols(file_name);
+
+    for (size_t symbol = 0; symbol < SYMBOLS_COUNT; ++symbol) {
+        frequencies_of_symbols[symbol] += frequencies_of_service_symbols[symbol];
+    }
+
+    return frequencies_of_symbols;
 }
 
-std::vector<size_t> Archiver::GetFrequenciesOfSymbols(Reader& reader_to_count_frequencies) const {
+std::vector<size_t> Archiver::GetFrequenciesOfServiceSymbols(
+    const std::vector<int>& file_name) const {
     std::vector<size_t> frequencies_of_symbols(SYMBOLS_COUNT);
 
     frequencies_of_symbols[FILENAME_END] = 1;
     frequencies_of_symbols[ONE_MORE_FILE] = 1;
     frequencies_of_symbols[ARCHIVE_END] = 1;
 
-    while (!reader_to_count_frequencies.bits_of_file_.empty()) {
-        reader_to_count_frequencies.ReadNextBits();
+    for (auto symbol : file_name) {
+        frequencies_of_symbols[symbol]++;
+    }
+
+    return frequencies_of_symbols;
+}
 
-        int symbol = reader_to_count_frequencies.GetValueOfNextBits(NUMBER_OF_BITS_IN_BYTE);
+std::vector<size_t> Archiver::GetFrequenciesOfBytes(const char* data, size_t size) const {
+    std::vector<size_t> frequencies_of_symbols(SYMBOLS_COUNT);
 
-        frequencies_of_symbols[symbol]++;
+    Histogram::Count(data, size, frequencies_of_symbols);
+
+    return frequencies_of_symbols;
+}
+
+std::vector<size_t> Archiver::GetFrequenciesOfBytes(const char* data, size_t size,
+                                                    uint32_t& checksum) const {
+    std::vector<size_t> frequencies_of_symbols(SYMBOLS_COUNT);
+
+    for (size_t index = 0; index < size; index += BitReader::BUFFER_SIZE) {
+        size_t size_of_chunk = std::min(size - index, BitReader::BUFFER_SIZE);
+
+        Histogram::Count(data + index, size_of_chunk, frequencies_of_symbols);
+        checksum = Crc32c::Extend(checksum, data + index, size_of_chunk);
+    }
+
+    return frequencies_of_symbols;
+}
+
+std::vector<size_t> Archiver::GetFrequenciesOfBytes(BitReader& reader, uint32_t& checksum) const {
+    std::vector<size_t> frequencies_of_symbols(SYMBOLS_COUNT);
 
-        reader_to_count_frequencies.DeleteUselessBitsAtTheBeginning(NUMBER_OF_BITS_IN_BYTE);
+    while (reader.ReadNextChunk()) {
+        Histogram::Count(reader.data_, reader.end_, frequencies_of_symbols);
+        checksum = Crc32c::Extend(checksum, reader.data_, reader.end_);
     }
+
     return frequencies_of_symbols;
 }
 
+size_t Archiver::GetSizeOfHuffmanCode(const std::vector<size_t>& frequencies_of_symbols,
+                                      const Huffman& huffman) const {
+    return ALPHABET_SIZE * (1 + GetNumberOfSymbols(frequencies_of_symbols) +
+                            huffman.number_of_codes_with_size.size() - 1) +
+           GetSizeOfCodedSymbols(frequencies_of_symbols, huffman);
+}
+
+size_t Archiver::GetSizeOfCodedSymbols(const std::vector<size_t>& frequencies_of_symbols,
+                                       const Huffman& huffman) const {
+    size_t size_of_code = 0;
+
+    // No symbol after ARCHIVE_END is ever coded.
+    for (size_t symbol = 0; symbol <= ARCHIVE_END; ++symbol) {
+        size_of_code += frequencies_of_symbols[symbol] * huffman.code_of_symbol[symbol].length;
+    }
+
+    return size_of_code;
+}
+
+size_t Archiver::ChooseSharedTable(const std::vector<size_t>& frequencies_of_symbols,
+                                   const std::vector<Huffman>& shared_tables) const {
+    size_t number_of_table = 0;
+    size_t min_size_of_code = 0;
+
+    for (size_t index = 0; index < shared_tables.size(); ++index) {
+        size_t size_of_code = GetSizeOfCodedSymbols(frequencies_of_symbols, shared_tables[index]);
+
+        if (index == 0 || size_of_code < min_size_of_code) {
+            number_of_table = index;
+            min_size_of_code = size_of_code;
+        }
+    }
+
+    return number_of_table;
+}
+
+std::vector<Huffman> Archiver::BuildSharedTables(const std::vector<std::string>& file_names) const {
+    std::vector<Huffman> shared_tables;
+
+    if (number_of_shared_tables == 0 || IsEveryFileBlocked()) {
+        return shared_tables;
+    }
+
+    // The tables are built from a sample of evenly spaced files, so that not all files are read
+    // twice. Only files which are read into memory become members coded by the shared tables.
+    const size_t number_of_samples = std::min(file_names.size(), MAX_NUMBER_OF_SAMPLES);
+
+    std::vector<std::vector<size_t>> frequencies_of_files;
+    std::vector<size_t> sizes_of_files;
+    std::vector<char> file_buffer;
+
+    for (size_t sample = 0; sample < number_of_samples; ++sample) {
+        const std::string& file_name = file_names[sample * file_names.size() / number_of_samples];
+
+        if (file_name == STANDARD_STREAM_NAME ||
+            GetSizeOfFile(file_name) > max_buffered_file_size) {
+            continue;
+        }
+
+        ReadWholeFile(file_name, file_buffer);
+
+        frequencies_of_files.push_back(GetFrequenciesOfSymbols(
+            GetFrequenciesOfBytes(file_buffer.data(), file_buffer.size()),
+            TransformStringToNumbers(Manifest::GetNameInArchive(file_name))));
+        sizes_of_files.push_back(std::accumulate(frequencies_of_files.back().begin(),
+                                                 frequencies_of_files.back().end(), size_t{0}));
+    }
+
+    if (frequencies_of_files.empty()) {
+        return shared_tables;
+    }
+
+    const size_t number_of_files = frequencies_of_files.size();
+    const size_t number_of_tables = std::min(number_of_shared_tables, number_of_files);
+
+    // Farthest first: the first table is the one of the largest file, every next one is the one of
+    // the file coded longest per symbol by the tables chosen before.
+    size_t next_file =
+        std::max_element(sizes_of_files.begin(), sizes_of_files.end()) - sizes_of_files.begin();
+
+    while (shared_tables.size() < number_of_tables) {
+        shared_tables.push_back(BuildSharedTable(frequencies_of_files, {next_file}));
+
+        double max_size_of_symbol = 0;
+
+        for (size_t index = 0; index < number_of_files; ++index) {
+            const Huffman& huffman =
+                shared_tables[ChooseSharedTable(frequencies_of_files[index], shared_tables)];
+            double size_of_symbol =
+                static_cast<double>(GetSizeOfCodedSymbols(frequencies_of_files[index], huffman)) /
+                static_cast<double>(sizes_of_files[index]);
+
+            if (size_of_symbol > max_size_of_symbol) {
+                max_size_of_symbol = size_of_symbol;
+                next_file = index;
+            }
+        }
+    }
+
+    // Then every table is built again from the files it codes shortest, a few times.
+    for (size_t round = 0; round < NUMBER_OF_CLUSTERING_ROUNDS; ++round) {
+        std::vector<std::vector<size_t>> clusters(shared_tables.size());
+
+        for (size_t index = 0; index < number_of_files; ++index) {
+            clusters[ChooseSharedTable(frequencies_of_files[index], shared_tables)].push_back(
+                index);
+        }
+
+        shared_tables.clear();
+
+        for (const auto& cluster : clusters) {
+            if (!cluster.empty()) {
+                shared_tables.push_back(BuildSharedTable(frequencies_of_files, cluster));
+            }
+        }
+    }
+
+    return shared_tables;
+}
+
+Huffman Archiver::BuildSharedTable(const std::vector<std::vector<size_t>>& frequencies_of_files,
+                                   const std::vector<size_t>& cluster) const {
+    // Every byte and service symbol gets a code, so that any file can be coded by the table.
+    std::vector<size_t> frequencies_of_symbols(SYMBOLS_COUNT);
+
+    for (size_t symbol = 0; symbol <= ARCHIVE_END; ++symbol) {
+        frequencies_of_symbols[symbol] = 1;
+    }
+
+    for (auto index : cluster) {
+        for (size_t symbol = 0; symbol <= ARCHIVE_END; ++symbol) {
+            frequencies_of_symbols[symbol] += frequencies_of_files[index][symbol];
+        }
+    }
+
+    return Huffman(frequencies_of_symbols);
+}
+
+size_t Archiver::ChooseTypeOfMember(const std::vector<size_t>& frequencies_of_bytes,
+                                    size_t size_of_huffman_member,
+                                    const std::string& next_file_name) const {
+    size_t size_of_file = 0;
+
+    for (auto frequency : frequencies_of_bytes) {
+        size_of_file += frequency;
+    }
+
+    const size_t size_of_raw_header =
+        ALPHABET_SIZE + 32 + next_file_name.size() * NUMBER_OF_BITS_IN_BYTE + 64 + ALPHABET_SIZE;
+
+    size_t size_of_stored_member = size_of_raw_header + size_of_file * NUMBER_OF_BITS_IN_BYTE;
+
+    if (GetNumberOfSymbols(frequencies_of_bytes) <= 1 &&
+        size_of_raw_header + NUMBER_OF_BITS_IN_BYTE < size_of_huffman_member) {
+        return RLE_MEMBER;
+    }
+
+    if (size_of_stored_member < size_of_huffman_member) {
+        return STORED_MEMBER;
+    }
+
+    return HUFFMAN_MEMBER;
+}
+
+int Archiver::GetMostFrequentByte(const std::vector<size_t>& frequencies_of_bytes) const {
+    return static_cast<int>(
+        std::max_element(frequencies_of_bytes.begin(),
+                         frequencies_of_bytes.begin() + (1 << NUMBER_OF_BITS_IN_BYTE)) -
+        frequencies_of_bytes.begin());
+}
+
 size_t Archiver::GetNumberOfSymbols(const std::vector<size_t>& frequencies_of_symbols) const {
     size_t number_of_symbols = 0;
 
@@ -130,12 +2119,8 @@ size_t Archiver::GetNumberOfSymbols(const std::vector<size_t>& frequencies_of_sy
     return number_of_symbols;
 }
 
-void Archiver::PushNumberToDequeBool(Writer& writer, std::deque<bool>& vec, int number) const {
-    for (size_t index = 0; index < ALPHABET_SIZE; ++index) {
-        vec.push_back((number >> index) & 1);
-    }
-
-    writer.PushTillCan();
+void Archiver::PushNumber(BitWriter& writer, int number) const {
+    writer.Put(static_cast<uint64_t>(number), ALPHABET_SIZE);
 }
 
 int Archiver::GetIntFromChar(char character) const {
@@ -160,11 +2145,6 @@ std::vector<int> Archiver::TransformStringToNumbers(const std::string& str) cons
     return numbers;
 }
 
-void Archiver::AppearVectorBoolToDequeBool(Writer& writer, std::deque<bool>& bits,
-                                           const std::vector<bool>& to_push) const {
-    for (auto bit : to_push) {
-        bits.push_back(bit);
-    }
-
-    writer.PushTillCan();
+void Archiver::PushCode(BitWriter& writer, const Huffman::Code& code) const {
+    writer.Put(code.bits, code.length);
 }
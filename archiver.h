@@ -3,10 +3,24 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <deque>
 #include <exception>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_set>
+#include <bit>
+#include <filesystem>
 
 #include "huffman.h"
+#include "thread_pool.h"
+#include "archive_index.h"
+#include "histogram.h"
+#include "statistics.h"
+#include "crc32c.h"
+#include "lz77.h"
+#include "context_model.h"
+#include "manifest.h"
 
 class Archiver {
 public:
@@ -16,27 +30,327 @@ public:
     const static size_t FILENAME_END;
     const static size_t ONE_MORE_FILE;
     const static size_t ARCHIVE_END;
+    const static size_t DEFAULT_MAX_BUFFERED_FILE_SIZE;
+    // A member starting with BLOCKED_MEMBER instead of the number of symbols stores its name as
+    // a 32-bit length and bytes, then blocks as (32-bit size, 32-bit compressed size, compressed
+    // bytes) up to a zero size, then a 9-bit ONE_MORE_FILE or ARCHIVE_END. Every compressed
+    // block is a block type byte followed by its own table of codes and the coded bytes. In a
+    // LIMITED_HUFFMAN_BLOCK the type byte is followed by a byte with the limit of code sizes. An
+    // INTERLEAVED_HUFFMAN_BLOCK has the limit and the table too, but its bytes are split into
+    // NUMBER_OF_STREAMS parts coded in byte-aligned streams after the 32-bit sizes of all of them
+    // but the last one.
+    const static size_t BLOCKED_MEMBER;
+    // A member starting with STORED_MEMBER stores its name like a blocked member, a 64-bit size
+    // and the bytes of the file as they are. An RLE_MEMBER stores the name, the 64-bit size and
+    // the only byte of the file. Both end with a 9-bit ONE_MORE_FILE or ARCHIVE_END.
+    const static size_t STORED_MEMBER;
+    const static size_t RLE_MEMBER;
+    // A CHECKSUMMED_MEMBER marker comes before a member whose ONE_MORE_FILE or ARCHIVE_END is
+    // followed by the 32-bit CRC-32C of the file. Archives are now written with
+    // CHECKSUMMED_MEMBER_WITH_NAME instead, whose CRC-32C is of the file followed by the name of
+    // the member, so that a damaged name is found as well.
+    const static size_t CHECKSUMMED_MEMBER;
+    const static size_t CHECKSUMMED_MEMBER_WITH_NAME;
+    // A MANIFEST marker at the start of an archive, before the shared tables, is followed by the
+    // padding of the last byte and a Manifest of the files and directories of the archive.
+    const static size_t MANIFEST;
+    // An APPENDED_MEMBERS marker after the padding of the last byte of ARCHIVE_END, or after the
+    // index which ended the archive before, starts members added to the archive later. They are
+    // laid out like an archive of their own up to ARCHIVE_END: a manifest, shared tables and
+    // members. The index of the whole archive follows the last of them.
+    const static size_t APPENDED_MEMBERS;
+    // Every SHARED_TABLE marker before the first member is followed by a table of codes of all
+    // bytes and service symbols. A SHARED_TABLE_MEMBER is followed by the 9-bit number of one of
+    // these tables, and then by the name and the bytes coded by it as in a legacy member.
+    const static size_t SHARED_TABLE;
+    const static size_t SHARED_TABLE_MEMBER;
+    const static size_t MAX_NUMBER_OF_SHARED_TABLES;
+    const static size_t NUMBER_OF_CLUSTERING_ROUNDS;
+    const static size_t MAX_NUMBER_OF_SAMPLES;
+    // Never written, since a Huffman member starts with its number of symbols.
+    const static size_t HUFFMAN_MEMBER;
+    const static size_t HUFFMAN_BLOCK;
+    const static size_t LIMITED_HUFFMAN_BLOCK;
+    const static size_t INTERLEAVED_HUFFMAN_BLOCK;
+    // The type byte of a STORED_BLOCK is followed by the bytes of the block as they are, and the
+    // one of an RLE_BLOCK by the only byte of the block.
+    const static size_t STORED_BLOCK;
+    const static size_t RLE_BLOCK;
+    // Two tables of codes, of bytes and match lengths and of match distances, and the tokens of
+    // Lz77 coded by them up to Lz77::END_OF_BLOCK. Code sizes are limited only in a
+    // LIMITED_LZ77_BLOCK and the tokens are in one stream.
+    const static size_t LZ77_BLOCK;
+    // A byte with the number of contexts, the 256 contexts of the bytes before the coded ones in
+    // as few bits as hold any context, a table of codes of every context and the bytes, each one
+    // coded by the table of the context of the byte before it. Code sizes are limited only in a
+    // LIMITED_CONTEXT_HUFFMAN_BLOCK and the bytes are in one stream.
+    const static size_t CONTEXT_HUFFMAN_BLOCK;
+    // An LZ77_BLOCK or a CONTEXT_HUFFMAN_BLOCK whose type byte is followed by a byte with the
+    // limit of code sizes of all its tables, as in a LIMITED_HUFFMAN_BLOCK.
+    const static size_t LIMITED_LZ77_BLOCK;
+    const static size_t LIMITED_CONTEXT_HUFFMAN_BLOCK;
+    // Set in the type byte of a block followed by the 32-bit CRC-32C of its bytes.
+    const static size_t CHECKSUMMED_BLOCK;
+    const static size_t NUMBER_OF_STREAMS;
+    const static size_t MAX_BLOCK_SIZE;
+    // A compressed block is at most this much larger than its bytes: the type byte of a stored
+    // block and its checksum, or the stream sizes and padding of an interleaved block that older
+    // archivers did not count when they chose to store it.
+    const static size_t MAX_BLOCK_OVERHEAD;
+    // -j is clamped to it, so that a typo does not start a thread for every number.
+    const static size_t MAX_NUMBER_OF_THREADS;
+    // Files named STANDARD_STREAM_NAME are read from stdin in blocks of STREAMING_BLOCK_SIZE and
+    // written to stdout; an archive with this name is written to stdout or read from stdin.
+    const static std::string STANDARD_STREAM_NAME;
+    const static size_t STREAMING_BLOCK_SIZE;
+
+    // The manifest and the shared tables of the members at the start of the archive or of the
+    // members appended to it.
+    struct Section {
+        Manifest manifest;
+        std::vector<Huffman> shared_tables;
+        // The number of the first member of the section in the index.
+        size_t first_member = 0;
+    };
 
     void Decompress(const char* file_name) const;
 
-    void Compress(int argc, char* argv[]) const;
+    // Returns true if the members listed in the index of the archive can be written by
+    // different threads, that is no two of them go to the same file or to stdout.
+    bool CanDecompressInParallel(const ArchiveIndex& index) const;
+
+    // Every member is decoded by a pool thread from its start bit in the index with a reader of
+    // its own.
+    void DecompressInParallel(const char* file_name, const ArchiveIndex& index,
+                              FileStatistics& total) const;
+
+    void Extract(const char* archive_name, const std::string& member_name) const;
+
+    // Reads the manifest and the shared tables at the start of the archive or of appended members.
+    Section ReadSection(BitReader& reader) const;
+
+    // Reads every section of the archive, finding the appended ones as gaps between members in
+    // the index, and checks that the members cover the rest of the archive.
+    std::vector<Section> ReadSections(const char* file_name, const ArchiveIndex& index) const;
+
+    // Reads the manifest at the start of the archive, if there is one.
+    Manifest ReadManifest(BitReader& reader) const;
+
+    // Reads the shared tables at the start of the archive, if there are any.
+    std::vector<Huffman> ReadSharedTables(BitReader& reader) const;
+
+    // Returns the terminating symbol of the member.
+    int DecompressNextMember(BitReader& reader, ThreadPool& pool,
+                             const std::vector<Huffman>& shared_tables,
+                             FileStatistics& statistics) const;
+
+    int DecompressNextFile(BitReader& reader, size_t number_of_symbols,
+                           FileStatistics& statistics) const;
+
+    // Decodes the name and the bytes of a member coded by huffman.
+    int DecodeNextFile(BitReader& reader, const Huffman& huffman,
+                       FileStatistics& statistics) const;
+
+    int DecompressNextBlockedFile(BitReader& reader, ThreadPool& pool,
+                                  FileStatistics& statistics) const;
+
+    int DecompressNextRawFile(BitReader& reader, size_t type_of_member,
+                              FileStatistics& statistics) const;
+
+    // Prints the statistics of the file and adds them to total.
+    void AddFileToStatistics(FileStatistics& total, const FileStatistics& statistics) const;
+
+    void PrintTotalStatistics(const FileStatistics& total,
+                              std::chrono::steady_clock::time_point start) const;
+
+    void DecompressBlock(const std::vector<char>& compressed_block,
+                         std::vector<char>& block) const;
+
+    // Decodes exactly size bytes to block; huffman is scratch memory reused between blocks.
+    void DecompressBlock(const char* compressed_block, size_t size_of_compressed_block,
+                         char* block, size_t size, Huffman& huffman) const;
+
+    // Decodes a block without its checksum.
+    void DecodeBlock(const char* compressed_block, size_t size_of_compressed_block, char* block,
+                     size_t size, Huffman& huffman) const;
+
+    void DecodeLz77Block(BitReader& reader, char* block, size_t size, size_t max_code_size,
+                         Huffman& huffman) const;
+
+    void DecodeContextBlock(BitReader& reader, char* block, size_t size,
+                            size_t max_code_size) const;
+
+    // Throws if a whole byte of a block is left after its last code.
+    void CheckEndOfBlock(BitReader& reader) const;
+
+    // Reads the byte with the limit of code sizes of a limited block.
+    size_t ReadCodeSizeLimit(BitReader& reader, size_t max_limit) const;
+
+    // Throws if a code is longer than max_code_size; codes up to DecodingTable::MAX_LOOKUP_BITS
+    // are decoded by one lookup.
+    void ReadTableOfCodes(BitReader& reader, Huffman& huffman, size_t max_code_size) const;
+
+    // Directories in file_names are archived with everything in them, and patterns are
+    // expanded.
+    void Compress(const std::string& archive_name,
+                  const std::vector<std::string>& file_names) const;
+
+    // Adds the files and a new index after the end of the archive, which must have an index; the
+    // members before them are not read. The old index is kept, so the archive is cut back to it
+    // if anything fails.
+    void Append(const std::string& archive_name, const std::vector<std::string>& file_names) const;
+
+    // Throws if there are no files to archive.
+    Manifest BuildManifest(const std::vector<std::string>& file_names) const;
+
+    // Writes the manifest, the shared tables and the members of its files up to ARCHIVE_END.
+    void PushSection(const Manifest& manifest, BitWriter& writer, ArchiveIndex& index,
+                     FileStatistics& total) const;
+
+    void CompressInParallel(const std::vector<std::string>& file_names,
+                            const std::vector<Huffman>& shared_tables, BitWriter& writer,
+                            ArchiveIndex& index, FileStatistics& total) const;
+
+    // Also sets the size of the file in the archive and prints its statistics.
+    void AddFileToIndex(ArchiveIndex& index, const std::string& file_name, size_t start_bit,
+                        const BitWriter& writer, FileStatistics& statistics,
+                        FileStatistics& total) const;
+
+    FileStatistics CompressNextFile(const std::string& next_file_name,
+                                    const std::vector<Huffman>& shared_tables, BitWriter& writer,
+                                    std::vector<char>& file_buffer, ThreadPool& pool,
+                                    bool is_last_file) const;
+
+    FileStatistics CompressNextMember(const std::string& next_file_name,
+                                      const std::vector<Huffman>& shared_tables,
+                                      BitWriter& writer, std::vector<char>& file_buffer,
+                                      ThreadPool& pool, bool is_last_file) const;
+
+    FileStatistics CompressNextBlockedFile(const std::string& next_file_name, BitWriter& writer,
+                                           ThreadPool& pool, bool is_last_file) const;
+
+    void CompressBlock(const char* block, size_t size, std::vector<char>& compressed_block) const;
 
-    void CompressNextFile(char* next_file_name, Writer& writer,
-                          std::deque<bool>& bits_to_push_in_archive,
-                          Reader& reader_to_count_frequencies,
-                          const std::string& next_file_name_str, const std::vector<int>& file_name,
-                          size_t index, int argc) const;
+    void CompressBlock(const char* block, size_t size, std::vector<char>& compressed_block,
+                       Huffman& huffman) const;
 
-    std::vector<size_t> GetFrequenciesOfSymbols(Reader& reader_to_count_frequencies) const;
+    void EncodeBlock(const char* block, size_t size,
+                     const std::vector<size_t>& frequencies_of_symbols,
+                     std::vector<char>& compressed_block, Huffman& huffman) const;
+
+    void EncodeLz77Block(const char* block, size_t size, std::vector<char>& compressed_block,
+                         Huffman& huffman) const;
+
+    void EncodeContextBlock(const char* block, size_t size,
+                            std::vector<char>& compressed_block) const;
+
+    void PushInterleavedStreams(BitWriter& writer, const Huffman& huffman, const char* block,
+                                size_t size) const;
+
+    // Options which need blocks split every file into them.
+    bool IsEveryFileBlocked() const;
+
+    FileStatistics CompressNextLargeFile(const std::string& next_file_name, BitWriter& writer,
+                                         const std::vector<int>& file_name,
+                                         bool is_last_file) const;
+
+    void PushHeaderOfNextFile(BitWriter& writer, const Huffman& huffman,
+                              size_t number_of_symbols, const std::vector<int>& file_name) const;
+
+    void PushTableOfCodes(BitWriter& writer, const Huffman& huffman,
+                          size_t number_of_symbols) const;
+
+    void PushCodedName(BitWriter& writer, const Huffman& huffman,
+                       const std::vector<int>& file_name) const;
+
+    void PushHeaderOfRawFile(BitWriter& writer, size_t type_of_member,
+                             const std::string& next_file_name, uint64_t size) const;
+
+    void PushSize(BitWriter& writer, uint64_t size) const;
+
+    uint64_t ReadSize(BitReader& reader) const;
+
+    void PushString(BitWriter& writer, const std::string& str) const;
+
+    std::unique_ptr<BitReader> OpenReader(const std::string& file_name) const;
+
+    std::unique_ptr<BitWriter> OpenWriter(const std::string& file_name) const;
+
+    // Throws for an absolute name or one with a ".." component, so that a member is never
+    // written out of the current directory.
+    std::unique_ptr<BitWriter> OpenWriterOfMember(const std::string& name) const;
+
+    std::string ReadString(BitReader& reader) const;
+
+    size_t GetSizeOfFile(const std::string& file_name) const;
+
+    void ReadWholeFile(const std::string& file_name, std::vector<char>& file_buffer) const;
+
+    std::vector<size_t> GetFrequenciesOfSymbols(const std::vector<size_t>& frequencies_of_bytes,
+                                                const std::vector<int>& file_name) const;
+
+    std::vector<size_t> GetFrequenciesOfServiceSymbols(const std::vector<int>& file_name) const;
+
+    std::vector<size_t> GetFrequenciesOfBytes(const char* data, size_t size) const;
+
+    // Also extends checksum with the bytes, chunk by chunk while they are in the cache.
+    std::vector<size_t> GetFrequenciesOfBytes(const char* data, size_t size,
+                                              uint32_t& checksum) const;
+
+    std::vector<size_t> GetFrequenciesOfBytes(BitReader& reader, uint32_t& checksum) const;
+
+    // The number of bits of the table of codes and of the coded symbols.
+    size_t GetSizeOfHuffmanCode(const std::vector<size_t>& frequencies_of_symbols,
+                                const Huffman& huffman) const;
+
+    size_t GetSizeOfCodedSymbols(const std::vector<size_t>& frequencies_of_symbols,
+                                 const Huffman& huffman) const;
+
+    // Returns the number of the shared table coding the symbols shortest.
+    size_t ChooseSharedTable(const std::vector<size_t>& frequencies_of_symbols,
+                             const std::vector<Huffman>& shared_tables) const;
+
+    // Clusters a sample of the files by k-means with the size of the code as the distance, into
+    // at most number_of_shared_tables clusters, and builds a table for every cluster.
+    std::vector<Huffman> BuildSharedTables(const std::vector<std::string>& file_names) const;
+
+    // The table of the sum of the frequencies of the files in cluster.
+    Huffman BuildSharedTable(const std::vector<std::vector<size_t>>& frequencies_of_files,
+                             const std::vector<size_t>& cluster) const;
+
+    // Returns HUFFMAN_MEMBER, STORED_MEMBER or RLE_MEMBER, whichever is the shortest.
+    size_t ChooseTypeOfMember(const std::vector<size_t>& frequencies_of_bytes,
+                              size_t size_of_huffman_member,
+                              const std::string& next_file_name) const;
+
+    int GetMostFrequentByte(const std::vector<size_t>& frequencies_of_bytes) const;
 
     size_t GetNumberOfSymbols(const std::vector<size_t>& frequencies_of_symbols) const;
 
-    void PushNumberToDequeBool(Writer& writer, std::deque<bool>& vec, int number) const;
+    void PushNumber(BitWriter& writer, int number) const;
 
     int GetIntFromChar(char character) const;
 
     std::vector<int> TransformStringToNumbers(const std::string& str) const;
 
-    void AppearVectorBoolToDequeBool(Writer& writer, std::deque<bool>& bits,
-                                     const std::vector<bool>& to_push) const;
+    void PushCode(BitWriter& writer, const Huffman::Code& code) const;
+
+    size_t max_buffered_file_size = DEFAULT_MAX_BUFFERED_FILE_SIZE;
+    bool print_statistics = false;
+    size_t number_of_threads = 1;
+    size_t block_size = 0;
+    bool write_index = true;
+    bool write_manifest = true;
+    // Zero means codes are limited only by Huffman::MAX_CODE_SIZE and go to HUFFMAN_BLOCK.
+    size_t code_size_limit = 0;
+    bool interleave_streams = false;
+    bool write_checksums = true;
+    bool block_checksums = false;
+    // Zero means every member has a table of its own.
+    size_t number_of_shared_tables = 0;
+    // Zero means blocks are coded without the LZ77 stage, else from Lz77::MIN_LEVEL to MAX_LEVEL.
+    size_t lz77_level = 0;
+    // Zero means every block has one table of codes, else at most this many tables, the one of a
+    // byte chosen by the byte before it.
+    size_t number_of_contexts = 0;
 };
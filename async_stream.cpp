@@ -0,0 +1,181 @@
+#include "async_stream.h"
+
+#include <stdexcept>
+
+const size_t ReadAhead::NUMBER_OF_BUFFERS = 4;
+const size_t WriteBehind::NUMBER_OF_BUFFERS = 4;
+
+ReadAhead::ReadAhead(std::istream& in, size_t buffer_size)
+    : in_(in), buffer_size_(buffer_size), free_buffers_(NUMBER_OF_BUFFERS) {
+    thread_ = std::thread([this]() { Read(); });
+}
+
+ReadAhead::~ReadAhead() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopped_ = true;
+    }
+
+    is_free_.notify_one();
+
+    thread_.join();
+}
+
+size_t ReadAhead::Next(std::vector<char>& buffer) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    is_filled_.wait(lock, [this]() { return !filled_buffers_.empty() || is_end_; });
+
+    if (filled_buffers_.empty()) {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+
+        return 0;
+    }
+
+    buffer.swap(filled_buffers_.front());
+    free_buffers_.push_back(std::move(filled_buffers_.front()));
+    filled_buffers_.pop_front();
+
+    lock.unlock();
+    is_free_.notify_one();
+
+    return buffer.size();
+}
+
+void ReadAhead::Read() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        is_free_.wait(lock, [this]() { return is_stopped_ || !free_buffers_.empty(); });
+
+        if (is_stopped_) {
+            return;
+        }
+
+        std::vector<char> buffer = std::move(free_buffers_.back());
+        free_buffers_.pop_back();
+
+        lock.unlock();
+
+        std::exception_ptr error;
+
+        try {
+            buffer.resize(buffer_size_);
+            in_.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.resize(static_cast<size_t>(in_.gcount()));
+        } catch (...) {
+            error = std::current_exception();
+            buffer.clear();
+        }
+
+        lock.lock();
+
+        if (buffer.empty()) {
+            error_ = error;
+            is_end_ = true;
+            is_filled_.notify_one();
+            return;
+        }
+
+        filled_buffers_.push_back(std::move(buffer));
+        is_filled_.notify_one();
+    }
+}
+
+WriteBehind::WriteBehind(std::ostream& out) : out_(out) {
+    thread_ = std::thread([this]() { Drain(); });
+}
+
+WriteBehind::~WriteBehind() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        is_written_.wait(lock, [this]() { return full_buffers_.empty() && !is_writing_; });
+        is_stopped_ = true;
+    }
+
+    has_buffer_.notify_one();
+
+    thread_.join();
+}
+
+void WriteBehind::Write(std::vector<char>& buffer) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    is_written_.wait(lock, [this]() { return full_buffers_.size() < NUMBER_OF_BUFFERS; });
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+
+    size_t capacity = buffer.capacity();
+
+    full_buffers_.push_back(std::move(buffer));
+
+    if (free_buffers_.empty()) {
+        buffer = std::vector<char>();
+        buffer.reserve(capacity);
+    } else {
+        buffer = std::move(free_buffers_.back());
+        free_buffers_.pop_back();
+    }
+
+    lock.unlock();
+    has_buffer_.notify_one();
+}
+
+void WriteBehind::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    is_written_.wait(lock, [this]() { return full_buffers_.empty() && !is_writing_; });
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+
+    // The thread waits for the next buffer, so the stream is not used by it now.
+    if (out_.fail() || !out_.flush()) {
+        throw std::runtime_error("error - cannot write file");
+    }
+}
+
+void WriteBehind::Drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        has_buffer_.wait(lock, [this]() { return is_stopped_ || !full_buffers_.empty(); });
+
+        if (full_buffers_.empty()) {
+            return;
+        }
+
+        std::vector<char> buffer = std::move(full_buffers_.front());
+        full_buffers_.pop_front();
+        is_writing_ = true;
+
+        lock.unlock();
+
+        try {
+            out_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+            // A full disk only sets the state of the stream.
+            if (out_.fail()) {
+                throw std::runtime_error("error - cannot write file");
+            }
+        } catch (...) {
+            lock.lock();
+            error_ = std::current_exception();
+            lock.unlock();
+        }
+
+        buffer.clear();
+
+        lock.lock();
+
+        free_buffers_.push_back(std::move(buffer));
+        is_writing_ = false;
+        is_written_.notify_all();
+    }
+}
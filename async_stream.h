@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Reads a stream ahead on a thread of its own into a ring of buffers, so that the bytes of one
+// buffer are decoded while the next ones are read.
+class ReadAhead {
+public:
+    const static size_t NUMBER_OF_BUFFERS;
+
+    ReadAhead(std::istream& in, size_t buffer_size);
+
+    ReadAhead(const ReadAhead&) = delete;
+
+    ReadAhead& operator=(const ReadAhead&) = delete;
+
+    // Stops reading, so that the stream can be used again when the object is destroyed.
+    ~ReadAhead();
+
+    // Swaps buffer with the next filled one and returns the number of bytes in it, which is zero
+    // at the end of the stream.
+    size_t Next(std::vector<char>& buffer);
+
+    void Read();
+
+    std::istream& in_;
+    size_t buffer_size_;
+
+    std::mutex mutex_;
+    std::condition_variable is_filled_;
+    std::condition_variable is_free_;
+
+    std::deque<std::vector<char>> filled_buffers_;
+    std::vector<std::vector<char>> free_buffers_;
+    bool is_end_ = false;
+    bool is_stopped_ = false;
+    std::exception_ptr error_;
+
+    std::thread thread_;
+};
+
+// Writes buffers to a stream on a thread of its own, so that the next bytes are coded while the
+// previous ones are written.
+class WriteBehind {
+public:
+    const static size_t NUMBER_OF_BUFFERS;
+
+    WriteBehind(std::ostream& out);
+
+    WriteBehind(const WriteBehind&) = delete;
+
+    WriteBehind& operator=(const WriteBehind&) = delete;
+
+    // Writes what is left before returning.
+    ~WriteBehind();
+
+    // Hands the bytes of buffer to the thread and gives back an empty buffer of its capacity.
+    void Write(std::vector<char>& buffer);
+
+    // Waits until everything handed over is written and flushes the stream. An error of a write,
+    // or a failed stream, is rethrown here or by the next Write.
+    void Flush();
+
+    void Drain();
+
+    std::ostream& out_;
+
+    std::mutex mutex_;
+    std::condition_variable has_buffer_;
+    std::condition_variable is_written_;
+
+    std::deque<std::vector<char>> full_buffers_;
+    std::vector<std::vector<char>> free_buffers_;
+    bool is_writing_ = false;
+    bool is_stopped_ = false;
+    std::exception_ptr error_;
+
+    std::thread thread_;
+};
@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include "../bit_reader.h"
+#include "../bit_writer.h"
+
+namespace {
+
+const size_t NUMBER_OF_BITS_IN_BYTE = 8;
+const size_t NUMBER_OF_BITS_TO_SEE = 50;
+
+// The std::deque<bool> bit I/O the archiver used before BitReader/BitWriter.
+class LegacyReader {
+public:
+    LegacyReader(std::istream& in) : in_(in) {
+        ReadNextBits();
+    }
+
+    void ReadNextBits() {
+        char character;
+
+        while (bits_of_file_.size() < NUMBER_OF_BITS_TO_SEE && in_ >> std::noskipws >> character) {
+            for (size_t index = 0; index < NUMBER_OF_BITS_IN_BYTE; ++index) {
+                bits_of_file_.push_back((character >> index) & 1);
+            }
+        }
+    }
+
+    void DeleteUselessBitsAtTheBeginning(size_t count) {
+        for (size_t index = 0; index < count; ++index) {
+            bits_of_file_.pop_front();
+        }
+
+        ReadNextBits();
+    }
+
+    int GetValueOfNextBits(size_t size) {
+        ReadNextBits();
+
+        int value = 0;
+
+        for (size_t index = 0; index < size; ++index) {
+            if (bits_of_file_[index]) {
+                value |= (1 << index);
+            }
+        }
+
+        return value;
+    }
+
+    std::istream& in_;
+    std::deque<bool> bits_of_file_;
+};
+
+class LegacyWriter {
+public:
+    LegacyWriter(std::ostream& out) : out_(out) {
+    }
+
+    void PushOneNumber() {
+        size_t size_of_number = std::min(NUMBER_OF_BITS_IN_BYTE, bits_to_push_.size());
+
+        char character = 0;
+
+        for (size_t index = 0; index < size_of_number; ++index) {
+            if (bits_to_push_.front()) {
+                character |= (1 << index);
+            }
+
+            bits_to_push_.pop_front();
+        }
+
+        out_ << character;
+    }
+
+    void PushTillCan() {
+        while (bits_to_push_.size() >= NUMBER_OF_BITS_IN_BYTE) {
+            PushOneNumber();
+        }
+    }
+
+    void PushTillEnd() {
+        while (!bits_to_push_.empty()) {
+            PushOneNumber();
+        }
+    }
+
+    std::ostream& out_;
+    std::deque<bool> bits_to_push_;
+};
+
+template <class Function>
+double MeasureMegabytesPerSecond(size_t bytes, Function function) {
+    auto start = std::chrono::steady_clock::now();
+
+    function();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(bytes) / (1 << 20) / elapsed.count();
+}
+
+void Report(const std::string& name, double legacy, double current) {
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << legacy << " MB/s (deque<bool>) "
+              << std::setw(12) << current << " MB/s (BitReader/BitWriter) " << std::setw(8)
+              << current / legacy << "x\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4) << 20;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> length_distribution(1, 16);
+
+    std::vector<std::pair<uint64_t, size_t>> codes;
+    size_t total_bits = 0;
+
+    while (total_bits < size * NUMBER_OF_BITS_IN_BYTE) {
+        size_t length = length_distribution(generator);
+        codes.emplace_back(generator() & ((1u << length) - 1), length);
+        total_bits += length;
+    }
+
+    std::ostringstream legacy_output;
+    double legacy_write = MeasureMegabytesPerSecond(size, [&] {
+        LegacyWriter writer(legacy_output);
+
+        for (const auto& [code, length] : codes) {
+            for (size_t index = 0; index < length; ++index) {
+                writer.bits_to_push_.push_back((code >> index) & 1);
+            }
+
+            writer.PushTillCan();
+        }
+
+        writer.PushTillEnd();
+    });
+
+    std::ostringstream current_output;
+    double current_write = MeasureMegabytesPerSecond(size, [&] {
+        BitWriter writer(current_output);
+
+        for (const auto& [code, length] : codes) {
+            writer.Put(code, length);
+        }
+
+        writer.PushTillEnd();
+    });
+
+    if (legacy_output.str() != current_output.str()) {
+        std::cerr << "error - bit writers disagree\n";
+        return 1;
+    }
+
+    std::string data = current_output.str();
+    size_t checksum_of_legacy = 0;
+    size_t checksum_of_current = 0;
+
+    std::istringstream legacy_input(data);
+    double legacy_read = MeasureMegabytesPerSecond(data.size(), [&] {
+        LegacyReader reader(legacy_input);
+
+        while (!reader.bits_of_file_.empty()) {
+            checksum_of_legacy += reader.GetValueOfNextBits(NUMBER_OF_BITS_IN_BYTE);
+            reader.DeleteUselessBitsAtTheBeginning(NUMBER_OF_BITS_IN_BYTE);
+        }
+    });
+
+    std::istringstream current_input(data);
+    double current_read = MeasureMegabytesPerSecond(data.size(), [&] {
+        BitReader reader(current_input);
+
+        while (!reader.IsEnd()) {
+            checksum_of_current += reader.Read(NUMBER_OF_BITS_IN_BYTE);
+        }
+    });
+
+    if (checksum_of_legacy != checksum_of_current) {
+        std::cerr << "error - bit readers disagree\n";
+        return 1;
+    }
+
+    Report("write", legacy_write, current_write);
+    Report("read", legacy_read, current_read);
+
+    return 0;
+}
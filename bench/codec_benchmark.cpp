@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+
+#include "../codec.h"
+
+namespace {
+
+template <class Function>
+double MeasureBuffersPerSecond(size_t count, Function function) {
+    auto start = std::chrono::steady_clock::now();
+
+    function();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(count) / elapsed.count();
+}
+
+void RoundTrip(Codec& codec, const std::vector<std::byte>& buffer,
+               std::vector<std::byte>& compressed, std::vector<std::byte>& decompressed) {
+    compressed.clear();
+    codec.Compress(buffer, compressed);
+
+    decompressed.resize(buffer.size());
+    codec.Decompress(compressed, std::span<std::byte>(decompressed));
+
+    if (decompressed != buffer) {
+        std::cerr << "error - buffer decoded wrong\n";
+        std::exit(1);
+    }
+}
+
+// Compresses random buffers, which are about as large coded as stored, into buffers of the largest
+// compressed size.
+void CheckMaxCompressedSize(bool interleave_streams, int number_of_bytes) {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> byte_distribution(0, number_of_bytes - 1);
+
+    Codec codec;
+    codec.archiver.interleave_streams = interleave_streams;
+    codec.archiver.block_size = 1 << 12;
+
+    std::vector<std::byte> buffer;
+    std::vector<std::byte> compressed;
+    std::vector<std::byte> decompressed;
+
+    for (size_t size = 1; size <= 3 * codec.archiver.block_size; size += 7) {
+        buffer.resize(size);
+
+        for (auto& byte : buffer) {
+            byte = static_cast<std::byte>(byte_distribution(generator));
+        }
+
+        compressed.resize(codec.GetMaxCompressedSize(size));
+        compressed.resize(codec.Compress(buffer, std::span<std::byte>(compressed)));
+
+        decompressed.resize(size);
+        codec.Decompress(compressed, std::span<std::byte>(decompressed));
+
+        if (decompressed != buffer) {
+            std::cerr << "error - buffer decoded wrong\n";
+            std::exit(1);
+        }
+    }
+}
+
+}  // namespace
+
+// Compresses and decompresses many small buffers with one codec and with a codec for every one.
+int main(int argc, char* argv[]) {
+    size_t number_of_buffers = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    size_t size_of_buffer = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+
+    for (int number_of_bytes : {16, 64, 256}) {
+        CheckMaxCompressedSize(false, number_of_bytes);
+        CheckMaxCompressedSize(true, number_of_bytes);
+    }
+
+    std::mt19937 generator(42);
+    std::geometric_distribution<int> byte_distribution(0.03);
+
+    std::vector<std::vector<std::byte>> buffers(number_of_buffers);
+
+    for (auto& buffer : buffers) {
+        buffer.resize(size_of_buffer);
+
+        for (auto& byte : buffer) {
+            byte = static_cast<std::byte>(byte_distribution(generator));
+        }
+    }
+
+    std::vector<std::byte> compressed;
+    std::vector<std::byte> decompressed;
+
+    double fresh = MeasureBuffersPerSecond(number_of_buffers, [&] {
+        for (const auto& buffer : buffers) {
+            Codec codec;
+            RoundTrip(codec, buffer, compressed, decompressed);
+        }
+    });
+
+    Codec codec;
+    double reused = MeasureBuffersPerSecond(number_of_buffers, [&] {
+        for (const auto& buffer : buffers) {
+            RoundTrip(codec, buffer, compressed, decompressed);
+        }
+    });
+
+    std::cout << std::left << std::setw(16) << "fresh codec" << std::right << std::fixed
+              << std::setprecision(0) << std::setw(10) << fresh << " buffers/s\n"
+              << std::left << std::setw(16) << "reused codec" << std::right << std::setw(10)
+              << reused << " buffers/s " << std::setprecision(2) << reused / fresh << "x\n";
+
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+
+#include "../archive_reader.h"
+
+namespace {
+
+struct CorpusSet {
+    std::string name;
+    std::vector<std::vector<char>> files;
+};
+
+struct Configuration {
+    std::string name;
+    size_t block_size = 0;
+    size_t code_size_limit = 0;
+    bool interleave_streams = false;
+    size_t number_of_shared_tables = 0;
+    size_t lz77_level = 0;
+    size_t number_of_contexts = 0;
+};
+
+std::vector<char> GenerateRandom(std::mt19937& generator, size_t size) {
+    std::vector<char> data(size);
+
+    for (auto& character : data) {
+        character = static_cast<char>(generator());
+    }
+
+    return data;
+}
+
+// Words of lowercase letters of English frequencies, separated by spaces and line breaks.
+std::vector<char> GenerateText(std::mt19937& generator, size_t size) {
+    const std::string letters = "etaoinshrdlcumwfgypbvkjxqz";
+    std::geometric_distribution<int> letter_distribution(0.15);
+    std::uniform_int_distribution<int> length_distribution(1, 10);
+
+    std::vector<char> data;
+    data.reserve(size);
+
+    while (data.size() < size) {
+        for (int length = length_distribution(generator); length > 0; --length) {
+            data.push_back(letters[letter_distribution(generator) % letters.size()]);
+        }
+
+        data.push_back(generator() % 12 == 0 ? '\n' : ' ');
+    }
+
+    data.resize(size);
+
+    return data;
+}
+
+std::vector<char> GenerateSkewed(std::mt19937& generator, size_t size) {
+    std::geometric_distribution<int> byte_distribution(0.5);
+
+    std::vector<char> data(size);
+
+    for (auto& character : data) {
+        character = static_cast<char>(byte_distribution(generator));
+    }
+
+    return data;
+}
+
+std::vector<CorpusSet> GenerateCorpus(size_t size) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<size_t> tiny_size_distribution(16, 512);
+
+    std::vector<CorpusSet> corpus = {{"random", {GenerateRandom(generator, size)}},
+                                     {"text", {GenerateText(generator, size)}},
+                                     {"skewed", {GenerateSkewed(generator, size)}},
+                                     {"tiny_files", {}},
+                                     {"huge_file", {GenerateText(generator, 8 * size)}}};
+
+    for (size_t total_size = 0; total_size < size / 4;) {
+        corpus[3].files.push_back(GenerateText(generator, tiny_size_distribution(generator)));
+        total_size += corpus[3].files.back().size();
+    }
+
+    return corpus;
+}
+
+size_t GetSizeOfSet(const CorpusSet& set) {
+    size_t size = 0;
+
+    for (const auto& file : set.files) {
+        size += file.size();
+    }
+
+    return size;
+}
+
+template <class Function>
+double MeasureBestSeconds(size_t repetitions, Function function) {
+    double best = 0;
+
+    for (size_t repetition = 0; repetition < repetitions; ++repetition) {
+        auto start = std::chrono::steady_clock::now();
+
+        function();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (repetition == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+
+    return best;
+}
+
+double GetMegabytesPerSecond(size_t bytes, double seconds) {
+    return static_cast<double>(bytes) / (1 << 20) / seconds;
+}
+
+// Compresses the files of the set to an archive and reads it back through ArchiveReader, so that
+// decompression is measured without writing files.
+void ReportSet(std::ostream& out, const CorpusSet& set,
+               const std::vector<Configuration>& configurations,
+               const std::filesystem::path& directory, size_t repetitions) {
+    std::vector<std::string> file_names;
+
+    for (size_t index = 0; index < set.files.size(); ++index) {
+        file_names.push_back((directory / (set.name + "_" + std::to_string(index))).string());
+
+        std::ofstream file(file_names.back(), std::ios_base::binary);
+        file.write(set.files[index].data(), static_cast<std::streamsize>(set.files[index].size()));
+    }
+
+    std::string archive_name = (directory / (set.name + ".arc")).string();
+    size_t size = GetSizeOfSet(set);
+
+    out << "    {\"name\": \"" << set.name << "\", \"files\": " << set.files.size()
+        << ", \"bytes\": " << size << ", \"configurations\": [\n";
+
+    for (size_t index = 0; index < configurations.size(); ++index) {
+        Archiver archiver;
+        archiver.block_size = configurations[index].block_size;
+        archiver.code_size_limit = configurations[index].code_size_limit;
+        archiver.interleave_streams = configurations[index].interleave_streams;
+        archiver.number_of_shared_tables = configurations[index].number_of_shared_tables;
+        archiver.lz77_level = configurations[index].lz77_level;
+        archiver.number_of_contexts = configurations[index].number_of_contexts;
+
+        double compress_seconds =
+            MeasureBestSeconds(repetitions, [&] { archiver.Compress(archive_name, file_names); });
+
+        std::vector<char> chunk(BitReader::BUFFER_SIZE);
+        std::vector<char> buffer;
+        double decompress_seconds = MeasureBestSeconds(repetitions, [&] {
+            ArchiveReader reader(archive_name, archiver);
+            ArchiveReader::Member member;
+
+            for (const auto& file : set.files) {
+                if (!reader.NextMember(member)) {
+                    throw std::runtime_error("error - member is missing");
+                }
+
+                buffer.clear();
+
+                for (size_t count = reader.Read(chunk.data(), chunk.size()); count > 0;
+                     count = reader.Read(chunk.data(), chunk.size())) {
+                    buffer.insert(buffer.end(), chunk.begin(), chunk.begin() + count);
+                }
+
+                if (buffer != file) {
+                    throw std::runtime_error("error - member is decoded wrong");
+                }
+            }
+        });
+
+        size_t compressed_size = std::filesystem::file_size(archive_name);
+
+        out << "      {\"name\": \"" << configurations[index].name
+            << "\", \"compressed_bytes\": " << compressed_size << std::fixed
+            << std::setprecision(4) << ", \"ratio\": "
+            << static_cast<double>(compressed_size) / std::max<size_t>(1, size)
+            << std::setprecision(2)
+            << ", \"compress_mb_per_s\": " << GetMegabytesPerSecond(size, compress_seconds)
+            << ", \"decompress_mb_per_s\": " << GetMegabytesPerSecond(size, decompress_seconds)
+            << "}" << (index + 1 < configurations.size() ? "," : "") << "\n";
+    }
+
+    out << "    ]}";
+
+    for (const auto& file_name : file_names) {
+        std::filesystem::remove(file_name);
+    }
+
+    std::filesystem::remove(archive_name);
+}
+
+void ReportStage(std::ostream& out, const std::string& name, const std::string& unit, double value,
+                 bool is_last) {
+    out << "    {\"name\": \"" << name << "\", \"" << unit << "\": " << std::fixed
+        << std::setprecision(2) << value << "}" << (is_last ? "" : ",") << "\n";
+}
+
+// Measures every stage of the compression of one member of text on its own.
+void ReportStages(std::ostream& out, const std::vector<char>& data, size_t repetitions) {
+    Archiver archiver;
+    const std::vector<int> file_name = archiver.TransformStringToNumbers("text");
+
+    std::vector<size_t> frequencies_of_symbols;
+    double frequencies_seconds = MeasureBestSeconds(repetitions, [&] {
+        frequencies_of_symbols = archiver.GetFrequenciesOfSymbols(
+            archiver.GetFrequenciesOfBytes(data.data(), data.size()), file_name);
+    });
+
+    uint32_t checksum = 0;
+    double checksum_seconds = MeasureBestSeconds(
+        repetitions, [&] { checksum = Crc32c::Extend(0, data.data(), data.size()); });
+
+    const size_t number_of_tables = 10000;
+
+    Huffman huffman;
+    double build_seconds = MeasureBestSeconds(repetitions, [&] {
+        for (size_t index = 0; index < number_of_tables; ++index) {
+            huffman.Build(frequencies_of_symbols);
+        }
+    });
+
+    BitWriter writer;
+    double encode_seconds = MeasureBestSeconds(repetitions, [&] {
+        writer.buffer_.clear();
+
+        for (char character : data) {
+            archiver.PushCode(writer,
+                              huffman.code_of_symbol[static_cast<unsigned char>(character)]);
+        }
+
+        writer.PushTillEnd();
+    });
+
+    size_t number_of_symbols = archiver.GetNumberOfSymbols(frequencies_of_symbols);
+
+    BitWriter table_writer;
+    archiver.PushTableOfCodes(table_writer, huffman, number_of_symbols);
+    table_writer.PushTillEnd();
+
+    Huffman decoder;
+    double read_table_seconds = MeasureBestSeconds(repetitions, [&] {
+        for (size_t index = 0; index < number_of_tables; ++index) {
+            BitReader reader(table_writer.buffer_.data(), table_writer.buffer_.size());
+
+            decoder.GetOrderOfSymbols(reader, reader.Read(Archiver::ALPHABET_SIZE));
+            decoder.GetCodeOfSymbols(reader, number_of_symbols);
+        }
+    });
+
+    std::vector<char> decoded(data.size());
+
+    double decode_by_symbol_seconds = MeasureBestSeconds(repetitions, [&] {
+        BitReader reader(writer.buffer_.data(), writer.buffer_.size());
+
+        for (auto& character : decoded) {
+            character = decoder.TransformIntToChar(decoder.DecodeNextSymbol(reader));
+        }
+    });
+
+    double decode_seconds = MeasureBestSeconds(repetitions, [&] {
+        BitReader reader(writer.buffer_.data(), writer.buffer_.size());
+
+        decoder.DecodeInterleavedStreams({&reader}, decoded.data(), decoded.size());
+    });
+
+    if (decoded != data || Crc32c::Extend(0, decoded.data(), decoded.size()) != checksum) {
+        throw std::runtime_error("error - stages decoded wrong");
+    }
+
+    out << "  \"stages\": [\n";
+
+    ReportStage(out, "frequencies", "mb_per_s",
+                GetMegabytesPerSecond(data.size(), frequencies_seconds), false);
+    ReportStage(out, "checksum", "mb_per_s", GetMegabytesPerSecond(data.size(), checksum_seconds),
+                false);
+    ReportStage(out, "build_table", "tables_per_s", number_of_tables / build_seconds, false);
+    ReportStage(out, "encode", "mb_per_s", GetMegabytesPerSecond(data.size(), encode_seconds),
+                false);
+    ReportStage(out, "read_table", "tables_per_s", number_of_tables / read_table_seconds, false);
+    ReportStage(out, "decode_by_symbol", "mb_per_s",
+                GetMegabytesPerSecond(data.size(), decode_by_symbol_seconds), false);
+    ReportStage(out, "decode", "mb_per_s", GetMegabytesPerSecond(data.size(), decode_seconds),
+                true);
+
+    out << "  ]\n";
+}
+
+}  // namespace
+
+// Prints compression ratio and speed over a generated corpus, and the speed of every stage, as
+// JSON. The arguments are the size of a corpus set in MiB and the number of runs of every
+// measurement, of which the fastest one is reported.
+int main(int argc, char* argv[]) {
+    size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4) << 20;
+    size_t repetitions = std::max<size_t>(1, argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 3);
+
+    std::vector<CorpusSet> corpus = GenerateCorpus(size);
+
+    std::vector<Configuration> configurations = {{"default", 0, 0, false, 0, 0, 0},
+                                                 {"blocks", 1 << 20, 0, false, 0, 0, 0},
+                                                 {"interleaved", 1 << 20, 12, true, 0, 0, 0},
+                                                 {"shared_tables", 0, 0, false, 4, 0, 0},
+                                                 {"lz77", 1 << 20, 0, false, 0, 6, 0},
+                                                 {"contexts", 1 << 20, 0, false, 0, 0, 16}};
+
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() /
+        ("archiver_benchmark_" +
+         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(directory);
+
+    try {
+        std::cout << "{\n  \"corpus\": [\n";
+
+        for (size_t index = 0; index < corpus.size(); ++index) {
+            ReportSet(std::cout, corpus[index], configurations, directory, repetitions);
+
+            std::cout << (index + 1 < corpus.size() ? ",\n" : "\n");
+        }
+
+        std::cout << "  ],\n";
+
+        ReportStages(std::cout, corpus[1].files[0], repetitions);
+
+        std::cout << "}\n";
+    } catch (const std::exception& error) {
+        std::filesystem::remove_all(directory);
+
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+
+    std::filesystem::remove_all(directory);
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+
+#include "../archiver.h"
+
+namespace {
+
+double MeasureMegabytesPerSecond(const Archiver& archiver, const std::vector<char>& data,
+                                 size_t repetitions) {
+    std::vector<char> compressed_block;
+    archiver.CompressBlock(data.data(), data.size(), compressed_block);
+
+    std::vector<char> block(data.size());
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t repetition = 0; repetition < repetitions; ++repetition) {
+        archiver.DecompressBlock(compressed_block, block);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (block != data) {
+        std::cerr << "error - block decoded wrong\n";
+        std::exit(1);
+    }
+
+    return static_cast<double>(data.size() * repetitions) / (1 << 20) / elapsed.count();
+}
+
+}  // namespace
+
+// Decodes one block of text-like bytes coded in one stream and in interleaved streams.
+int main(int argc, char* argv[]) {
+    size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024) << 10;
+    size_t repetitions = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 32;
+
+    std::mt19937 generator(42);
+    std::geometric_distribution<int> text_distribution(0.05);
+
+    std::vector<char> data(size);
+
+    for (auto& character : data) {
+        character = static_cast<char>(' ' + text_distribution(generator) % 96);
+    }
+
+    for (size_t code_size_limit : {0, 12}) {
+        Archiver archiver;
+        archiver.code_size_limit = code_size_limit;
+
+        double one_stream = MeasureMegabytesPerSecond(archiver, data, repetitions);
+
+        archiver.interleave_streams = true;
+        double interleaved = MeasureMegabytesPerSecond(archiver, data, repetitions);
+
+        std::cout << "code size limit " << std::setw(2) << code_size_limit << ": " << std::fixed
+                  << std::setprecision(1) << std::setw(8) << one_stream << " MB/s (one stream) "
+                  << std::setw(8) << interleaved << " MB/s (" << Archiver::NUMBER_OF_STREAMS
+                  << " streams) " << std::setprecision(2) << interleaved / one_stream << "x\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+
+#include "../bit_reader.h"
+#include "../histogram.h"
+
+namespace {
+
+template <class Function>
+double MeasureMegabytesPerSecond(size_t bytes, size_t repetitions, Function function) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t repetition = 0; repetition < repetitions; ++repetition) {
+        function();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(bytes * repetitions) / (1 << 20) / elapsed.count();
+}
+
+void Report(const std::string& name, double megabytes_per_second, double baseline) {
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << megabytes_per_second << " MB/s "
+              << std::setprecision(2) << std::setw(8) << megabytes_per_second / baseline << "x\n";
+}
+
+}  // namespace
+
+// Counts bytes of random, text-like and constant data with every kernel.
+int main(int argc, char* argv[]) {
+    size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16) << 20;
+    size_t repetitions = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+
+    std::mt19937 generator(42);
+    std::geometric_distribution<int> text_distribution(0.05);
+
+    std::vector<std::pair<std::string, std::vector<char>>> inputs = {
+        {"random", std::vector<char>(size)},
+        {"text-like", std::vector<char>(size)},
+        {"constant", std::vector<char>(size, 'a')}};
+
+    for (size_t index = 0; index < size; ++index) {
+        inputs[0].second[index] = static_cast<char>(generator());
+        inputs[1].second[index] = static_cast<char>(' ' + text_distribution(generator) % 96);
+    }
+
+    for (const auto& [name, data] : inputs) {
+        std::cout << name << ":\n";
+
+        std::vector<size_t> expected(Histogram::NUMBER_OF_BYTE_VALUES);
+        double reader = MeasureMegabytesPerSecond(size, 1, [&] {
+            BitReader bit_reader(data.data(), data.size());
+
+            while (!bit_reader.IsEnd()) {
+                expected[bit_reader.Read(8)]++;
+            }
+        });
+
+        Report("  BitReader::Read(8)", reader, reader);
+
+        auto check = [&](const std::string& kernel_name, auto kernel) {
+            std::vector<size_t> frequencies(Histogram::NUMBER_OF_BYTE_VALUES);
+            double speed = MeasureMegabytesPerSecond(size, repetitions, [&] {
+                kernel(data.data(), data.size(), frequencies);
+            });
+
+            for (auto& frequency : frequencies) {
+                frequency /= repetitions;
+            }
+
+            if (frequencies != expected) {
+                std::cerr << "error - " << kernel_name << " counts wrong\n";
+                std::exit(1);
+            }
+
+            Report("  " + kernel_name, speed, reader);
+        };
+
+        check("one table", Histogram::CountWithOneTable);
+        check("8 sub-histograms", Histogram::CountWithSubHistograms);
+
+        if (Histogram::HasAvx2()) {
+            check("8 sub-histograms, AVX2", Histogram::CountWithAvx2);
+        }
+
+        check("Count (dispatched)", Histogram::Count);
+    }
+
+    return 0;
+}
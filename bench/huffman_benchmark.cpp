@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <queue>
+#include <random>
+
+#include "../huffman.h"
+
+namespace {
+
+// The tree the archiver built before the arena: every node is allocated with new and linked by
+// pointers. Unlike the old code it frees the tree, so the benchmark does not run out of memory.
+class LegacyVertex {
+public:
+    int symbol_of_vertex = -1;
+    size_t frequency_of_vertex = 0;
+    LegacyVertex* left_child = nullptr;
+    LegacyVertex* right_child = nullptr;
+};
+
+LegacyVertex* RunLegacyHuffman(const std::vector<size_t>& frequencies_of_alphabet) {
+    auto comparator_for_vertexes = [](const LegacyVertex* a, const LegacyVertex* b) {
+        return a->frequency_of_vertex > b->frequency_of_vertex;
+    };
+
+    std::priority_queue<LegacyVertex*, std::vector<LegacyVertex*>,
+                        decltype(comparator_for_vertexes)>
+        queue(comparator_for_vertexes);
+
+    for (size_t index = 0; index < Huffman::SYMBOLS_COUNT; ++index) {
+        if (frequencies_of_alphabet[index] == 0) {
+            continue;
+        }
+
+        LegacyVertex* leaf = new LegacyVertex();
+        leaf->frequency_of_vertex = frequencies_of_alphabet[index];
+        leaf->symbol_of_vertex = index;
+
+        queue.push(leaf);
+    }
+
+    while (queue.size() > 1) {
+        LegacyVertex* left_child = queue.top();
+        queue.pop();
+
+        LegacyVertex* right_child = queue.top();
+        queue.pop();
+
+        LegacyVertex* parent = new LegacyVertex();
+        parent->frequency_of_vertex =
+            left_child->frequency_of_vertex + right_child->frequency_of_vertex;
+        parent->left_child = left_child;
+        parent->right_child = right_child;
+
+        queue.push(parent);
+    }
+
+    return queue.top();
+}
+
+std::vector<size_t> GetLegacyLengthsOfCodes(LegacyVertex* root) {
+    std::vector<size_t> length_of_code(Huffman::SYMBOLS_COUNT);
+
+    std::function<void(LegacyVertex*, size_t)> dfs = [&](LegacyVertex* current,
+                                                         size_t current_length) {
+        if (current->symbol_of_vertex != -1) {
+            length_of_code[current->symbol_of_vertex] = current_length;
+        } else {
+            dfs(current->left_child, current_length + 1);
+            dfs(current->right_child, current_length + 1);
+        }
+
+        delete current;
+    };
+
+    dfs(root, 0);
+
+    return length_of_code;
+}
+
+template <class Function>
+double MeasureTablesPerSecond(size_t count, Function function) {
+    auto start = std::chrono::steady_clock::now();
+
+    function();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(count) / elapsed.count();
+}
+
+void Report(const std::string& name, double tables_per_second, double baseline) {
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(0) << std::setw(12) << tables_per_second << " tables/s "
+              << std::setprecision(2) << std::setw(8) << tables_per_second / baseline << "x\n";
+}
+
+}  // namespace
+
+// Builds one table per small file, as an archive of many small files does.
+int main(int argc, char* argv[]) {
+    size_t number_of_files = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    size_t size_of_file = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+
+    std::mt19937 generator(42);
+    std::geometric_distribution<int> byte_distribution(0.03);
+    std::uniform_int_distribution<int> name_distribution('a', 'z');
+
+    std::vector<std::vector<size_t>> frequencies(number_of_files);
+
+    for (auto& frequencies_of_file : frequencies) {
+        frequencies_of_file.assign(Huffman::SYMBOLS_COUNT, 0);
+
+        for (size_t index = 0; index < size_of_file; ++index) {
+            frequencies_of_file[byte_distribution(generator) % 256]++;
+        }
+
+        for (size_t index = 0; index < 12; ++index) {
+            frequencies_of_file[name_distribution(generator)]++;
+        }
+
+        frequencies_of_file[Huffman::FILENAME_END] = 1;
+        frequencies_of_file[Huffman::ONE_MORE_FILE] = 1;
+        frequencies_of_file[Huffman::ARCHIVE_END] = 1;
+    }
+
+    size_t checksum_of_legacy = 0;
+    double legacy = MeasureTablesPerSecond(number_of_files, [&] {
+        for (const auto& frequencies_of_file : frequencies) {
+            for (auto length : GetLegacyLengthsOfCodes(RunLegacyHuffman(frequencies_of_file))) {
+                checksum_of_legacy += length;
+            }
+        }
+    });
+
+    size_t checksum_of_arena = 0;
+    Huffman huffman;
+    double arena = MeasureTablesPerSecond(number_of_files, [&] {
+        for (const auto& frequencies_of_file : frequencies) {
+            for (auto length :
+                 huffman.GetLengthsOfCodes(huffman.RunHuffman(frequencies_of_file))) {
+                checksum_of_arena += length;
+            }
+        }
+    });
+
+    if (checksum_of_legacy != checksum_of_arena) {
+        std::cerr << "error - trees disagree\n";
+        return 1;
+    }
+
+    size_t checksum_of_tables = 0;
+    double tables = MeasureTablesPerSecond(number_of_files, [&] {
+        for (const auto& frequencies_of_file : frequencies) {
+            Huffman table(frequencies_of_file);
+            checksum_of_tables += table.code_of_symbol[Huffman::FILENAME_END].length;
+        }
+    });
+
+    Report("tree (new/delete)", legacy, legacy);
+    Report("tree (arena)", arena, legacy);
+    Report("whole table (arena)", tables, legacy);
+
+    return checksum_of_tables == 0;
+}
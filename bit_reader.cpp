@@ -0,0 +1,218 @@
+#include "bit_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+const size_t BitReader::BUFFER_SIZE = (1 << 16);
+const size_t BitReader::MAX_PEEK_BITS = 56;
+
+BitReader::BitReader(const char* file_name)
+    : file_(file_name, std::ios_base::in | std::ios_base::binary), in_(&file_) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("error - cannot open file named " +
+                                 static_cast<std::string>(file_name));
+    }
+
+    buffer_.resize(BUFFER_SIZE);
+    data_ = buffer_.data();
+}
+
+BitReader::BitReader(std::istream& in) : file_(), in_(&in) {
+    buffer_.resize(BUFFER_SIZE);
+    data_ = buffer_.data();
+}
+
+BitReader::BitReader(const char* data, size_t size)
+    : file_(), in_(nullptr), data_(data), end_(size), bytes_read_(size) {
+}
+
+uint64_t BitReader::Peek(size_t count) {
+    if (bits_in_buffer_ < count) {
+        Refill();
+    }
+
+    return bit_buffer_ & ((static_cast<uint64_t>(1) << count) - 1);
+}
+
+void BitReader::Consume(size_t count) {
+    if (count > bits_in_buffer_) {
+        throw std::runtime_error("error - unexpected end of file");
+    }
+
+    bit_buffer_ = (count == 64 ? 0 : bit_buffer_ >> count);
+    bits_in_buffer_ -= count;
+}
+
+uint64_t BitReader::Read(size_t count) {
+    uint64_t value = Peek(count);
+
+    Consume(count);
+
+    return value;
+}
+
+void BitReader::ReadBytes(char* output, size_t count) {
+    while (count > 0 && bits_in_buffer_ % 8 == 0 && bits_in_buffer_ > 0) {
+        *output++ = static_cast<char>(Read(8));
+        --count;
+    }
+
+    if (bits_in_buffer_ == 0) {
+        while (count > 0) {
+            if (position_ == end_ && !ReadNextChunk()) {
+                throw std::runtime_error("error - unexpected end of file");
+            }
+
+            size_t length = std::min(count, end_ - position_);
+            std::copy(data_ + position_, data_ + position_ + length, output);
+
+            position_ += length;
+            output += length;
+            count -= length;
+        }
+        return;
+    }
+
+    for (; count > 0; --count) {
+        if (Available() < 8) {
+            throw std::runtime_error("error - unexpected end of file");
+        }
+
+        *output++ = static_cast<char>(Read(8));
+    }
+}
+
+size_t BitReader::ReadSomeBytes(char* output, size_t count) {
+    size_t number_of_bytes = 0;
+
+    for (; number_of_bytes < count && bits_in_buffer_ % 8 == 0 && bits_in_buffer_ > 0;
+         ++number_of_bytes) {
+        output[number_of_bytes] = static_cast<char>(Read(8));
+    }
+
+    if (bits_in_buffer_ == 0) {
+        while (number_of_bytes < count && (position_ < end_ || ReadNextChunk())) {
+            size_t length = std::min(count - number_of_bytes, end_ - position_);
+            std::copy(data_ + position_, data_ + position_ + length, output + number_of_bytes);
+
+            position_ += length;
+            number_of_bytes += length;
+        }
+
+        return number_of_bytes;
+    }
+
+    for (; number_of_bytes < count && Available() >= 8; ++number_of_bytes) {
+        output[number_of_bytes] = static_cast<char>(Read(8));
+    }
+
+    return number_of_bytes;
+}
+
+void BitReader::AlignToByte() {
+    Consume(bits_in_buffer_ % 8);
+}
+
+void BitReader::SeekToBit(uint64_t bit) {
+    bit_buffer_ = 0;
+    bits_in_buffer_ = 0;
+
+    if (in_ == nullptr) {
+        if (bit / 8 > end_) {
+            throw std::runtime_error("error - unexpected end of file");
+        }
+
+        position_ = bit / 8;
+    } else if (bit / 8 >= bytes_read_ - end_ && bit / 8 <= bytes_read_) {
+        // The byte is still in the buffer, which holds the bytes before bytes_read_.
+        position_ = bit / 8 - (bytes_read_ - end_);
+    } else {
+        read_ahead_.reset();
+        number_of_chunks_ = 0;
+
+        in_->clear();
+        in_->seekg(static_cast<std::streamoff>(bit / 8));
+
+        if (!*in_) {
+            throw std::runtime_error("error - cannot seek in file");
+        }
+
+        position_ = 0;
+        end_ = 0;
+        bytes_read_ = bit / 8;
+    }
+
+    Read(bit % 8);
+}
+
+size_t BitReader::Available() {
+    Refill();
+
+    return bits_in_buffer_;
+}
+
+size_t BitReader::BytePosition() const {
+    return position_ - bits_in_buffer_ / 8;
+}
+
+uint64_t BitReader::BitsRead() const {
+    return (bytes_read_ - (end_ - position_)) * 8 - bits_in_buffer_;
+}
+
+bool BitReader::IsEnd() {
+    return Available() == 0;
+}
+
+void BitReader::Refill() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (bits_in_buffer_ <= MAX_PEEK_BITS && position_ + sizeof(uint64_t) <= end_) {
+        uint64_t word;
+        std::memcpy(&word, data_ + position_, sizeof(word));
+
+        size_t number_of_bytes = (63 - bits_in_buffer_) / 8;
+
+        bit_buffer_ |= word << bits_in_buffer_;
+        bits_in_buffer_ += number_of_bytes * 8;
+        bit_buffer_ &= (static_cast<uint64_t>(1) << bits_in_buffer_) - 1;
+        position_ += number_of_bytes;
+        return;
+    }
+#endif
+
+    while (bits_in_buffer_ <= MAX_PEEK_BITS) {
+        if (position_ == end_ && !ReadNextChunk()) {
+            return;
+        }
+
+        bit_buffer_ |= static_cast<uint64_t>(static_cast<unsigned char>(data_[position_++]))
+                       << bits_in_buffer_;
+        bits_in_buffer_ += 8;
+    }
+}
+
+bool BitReader::ReadNextChunk() {
+    if (in_ == nullptr || (read_ahead_ == nullptr && !*in_)) {
+        return false;
+    }
+
+    if (read_ahead_ == nullptr && number_of_chunks_ > 0) {
+        read_ahead_ = std::make_unique<ReadAhead>(*in_, BUFFER_SIZE);
+    }
+
+    if (read_ahead_ != nullptr) {
+        end_ = read_ahead_->Next(buffer_);
+        data_ = buffer_.data();
+    } else {
+        buffer_.resize(BUFFER_SIZE);
+        data_ = buffer_.data();
+
+        in_->read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        end_ = static_cast<size_t>(in_->gcount());
+    }
+
+    position_ = 0;
+    bytes_read_ += end_;
+    ++number_of_chunks_;
+
+    return end_ > 0;
+}
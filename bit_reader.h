@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+#include <memory>
+
+#include "async_stream.h"
+
+class BitReader {
+public:
+    const static size_t BUFFER_SIZE;
+    const static size_t MAX_PEEK_BITS;
+
+    BitReader(const char* file_name);
+
+    BitReader(std::istream& in);
+
+    BitReader(const char* data, size_t size);
+
+    BitReader(const BitReader&) = delete;
+
+    BitReader& operator=(const BitReader&) = delete;
+
+    // Returns the next count bits, the first one in the lowest bit. Bits after the end are zeros.
+    uint64_t Peek(size_t count);
+
+    void Consume(size_t count);
+
+    uint64_t Read(size_t count);
+
+    // Reads whole bytes; it is fast when the reader stands on a byte boundary.
+    void ReadBytes(char* output, size_t count);
+
+    // Reads whole bytes like ReadBytes, but stops at the end of the stream and returns the number
+    // of bytes read.
+    size_t ReadSomeBytes(char* output, size_t count);
+
+    void AlignToByte();
+
+    void SeekToBit(uint64_t bit);
+
+    size_t Available();
+
+    // The offset of the next byte in the memory of a memory reader standing on a byte boundary.
+    size_t BytePosition() const;
+
+    // The number of bits consumed, or the position in the file after SeekToBit.
+    uint64_t BitsRead() const;
+
+    bool IsEnd();
+
+    void Refill();
+
+    // The first chunk after opening or seeking is read here, the next ones by a ReadAhead, so
+    // that small files start no thread.
+    bool ReadNextChunk();
+
+    std::ifstream file_;
+    std::istream* in_;
+
+    std::vector<char> buffer_;
+    const char* data_ = nullptr;
+    size_t position_ = 0;
+    size_t end_ = 0;
+
+    uint64_t bit_buffer_ = 0;
+    size_t bits_in_buffer_ = 0;
+
+    size_t bytes_read_ = 0;
+    size_t number_of_chunks_ = 0;
+
+    // Declared last, so that its thread stops before the stream is closed.
+    std::unique_ptr<ReadAhead> read_ahead_;
+};
@@ -0,0 +1,166 @@
+#include "bit_writer.h"
+
+#include <algorithm>
+
+const size_t BitWriter::BUFFER_SIZE = (1 << 16);
+const size_t BitWriter::MAX_PUT_BITS = 56;
+
+BitWriter::BitWriter() : file_(), out_(nullptr) {
+}
+
+BitWriter::BitWriter(const std::string& file_name)
+    : file_(file_name, std::ios_base::trunc | std::ios_base::binary | std::ios_base::out),
+      out_(&file_) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("error - cannot create file named " + file_name);
+    }
+
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+BitWriter::BitWriter(const std::string& file_name, uint64_t offset)
+    : file_(file_name, std::ios_base::in | std::ios_base::out | std::ios_base::binary),
+      out_(&file_),
+      bytes_flushed_(offset) {
+    if (!file_.is_open() || !file_.seekp(static_cast<std::streamoff>(offset))) {
+        throw std::runtime_error("error - cannot open file named " + file_name);
+    }
+
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+BitWriter::BitWriter(std::ostream& out) : file_(), out_(&out) {
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+BitWriter::~BitWriter() {
+    if (out_ == nullptr) {
+        return;
+    }
+
+    try {
+        PushTillEnd();
+    } catch (...) {
+        // Errors are thrown by the PushTillEnd called before, which is how they are reported.
+    }
+}
+
+void BitWriter::Put(uint64_t code, size_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    if (bits_in_buffer_ + length > 64) {
+        PutWholeBytes();
+    }
+
+    bit_buffer_ |= (code & ((static_cast<uint64_t>(1) << length) - 1)) << bits_in_buffer_;
+    bits_in_buffer_ += length;
+}
+
+void BitWriter::PutWholeBytes() {
+    while (bits_in_buffer_ >= 8) {
+        buffer_.push_back(static_cast<char>(bit_buffer_ & 0xFF));
+
+        bit_buffer_ >>= 8;
+        bits_in_buffer_ -= 8;
+    }
+
+    if (out_ != nullptr && buffer_.size() >= BUFFER_SIZE) {
+        Flush();
+    }
+}
+
+void BitWriter::PutBytes(const char* data, size_t count) {
+    PutWholeBytes();
+
+    size_t index = 0;
+
+    if (bits_in_buffer_ == 0) {
+        buffer_.insert(buffer_.end(), data, data + count);
+        index = count;
+    }
+
+    for (; index + 7 <= count; index += 7) {
+        uint64_t word = 0;
+
+        for (size_t shift = 0; shift < 7; ++shift) {
+            word |= static_cast<uint64_t>(static_cast<unsigned char>(data[index + shift]))
+                    << (shift * 8);
+        }
+
+        Put(word, 56);
+    }
+
+    for (; index < count; ++index) {
+        Put(static_cast<unsigned char>(data[index]), 8);
+    }
+
+    PutWholeBytes();
+}
+
+void BitWriter::Append(const BitWriter& other) {
+    if (other.out_ != nullptr || other.bytes_flushed_ != 0) {
+        throw std::runtime_error("error - only memory writers can be appended");
+    }
+
+    PutBytes(other.buffer_.data(), other.buffer_.size());
+
+    uint64_t rest_of_bits = other.bit_buffer_;
+    size_t number_of_rest_bits = other.bits_in_buffer_;
+
+    while (number_of_rest_bits > 0) {
+        size_t length = std::min<size_t>(number_of_rest_bits, 32);
+
+        Put(rest_of_bits, length);
+
+        rest_of_bits >>= length;
+        number_of_rest_bits -= length;
+    }
+}
+
+void BitWriter::Flush() {
+    if (out_ == nullptr) {
+        return;
+    }
+
+    if (write_behind_ == nullptr && buffer_.size() >= BUFFER_SIZE) {
+        write_behind_ = std::make_unique<WriteBehind>(*out_);
+    }
+
+    bytes_flushed_ += buffer_.size();
+
+    if (write_behind_ != nullptr) {
+        write_behind_->Write(buffer_);
+    } else {
+        out_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+
+        if (out_->fail()) {
+            throw std::runtime_error("error - cannot write file");
+        }
+    }
+}
+
+void BitWriter::PushTillEnd() {
+    PutWholeBytes();
+
+    if (bits_in_buffer_ > 0) {
+        buffer_.push_back(static_cast<char>(bit_buffer_ & 0xFF));
+
+        bit_buffer_ = 0;
+        bits_in_buffer_ = 0;
+    }
+
+    Flush();
+
+    if (write_behind_ != nullptr) {
+        write_behind_->Flush();
+    } else if (out_ != nullptr && !out_->flush()) {
+        throw std::runtime_error("error - cannot write file");
+    }
+}
+
+size_t BitWriter::BitsWritten() const {
+    return (bytes_flushed_ + buffer_.size()) * 8 + bits_in_buffer_;
+}
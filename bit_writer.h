@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+#include <memory>
+
+#include "async_stream.h"
+
+class BitWriter {
+public:
+    const static size_t BUFFER_SIZE;
+    const static size_t MAX_PUT_BITS;
+
+    BitWriter();
+
+    BitWriter(const std::string& file_name);
+
+    // Writes over the file from the byte offset on and keeps the bytes before it, which are
+    // counted in BitsWritten.
+    BitWriter(const std::string& file_name, uint64_t offset);
+
+    BitWriter(std::ostream& out);
+
+    BitWriter(const BitWriter&) = delete;
+
+    BitWriter& operator=(const BitWriter&) = delete;
+
+    ~BitWriter();
+
+    // Appends the lowest length bits of code, the lowest bit first.
+    void Put(uint64_t code, size_t length);
+
+    void PutWholeBytes();
+
+    // Appends whole bytes; it is fast when the writer stands on a byte boundary.
+    void PutBytes(const char* data, size_t count);
+
+    // Appends everything written to other, which must be a memory writer.
+    void Append(const BitWriter& other);
+
+    // Hands the buffer to a WriteBehind once it is full for the first time, and writes it here
+    // before that, so that small files start no thread.
+    void Flush();
+
+    // Throws if anything written to the stream failed. The destructor calls it too but ignores
+    // errors, so a writer of a file must call it before it is destroyed.
+    void PushTillEnd();
+
+    size_t BitsWritten() const;
+
+    std::ofstream file_;
+    std::ostream* out_;
+
+    std::vector<char> buffer_;
+    size_t bytes_flushed_ = 0;
+
+    uint64_t bit_buffer_ = 0;
+    size_t bits_in_buffer_ = 0;
+
+    // Declared last, so that its thread stops before the stream is closed.
+    std::unique_ptr<WriteBehind> write_behind_;
+};
@@ -0,0 +1,211 @@
+#include "codec.h"
+
+#include <algorithm>
+
+const size_t Codec::SIZE_OF_BLOCK_HEADER = 8;
+
+namespace {
+
+void PutWord(std::byte* output, size_t word) {
+    for (size_t index = 0; index < 4; ++index) {
+        output[index] = static_cast<std::byte>((word >> (index * 8)) & 0xFF);
+    }
+}
+
+size_t GetWord(const std::byte* input) {
+    size_t word = 0;
+
+    for (size_t index = 0; index < 4; ++index) {
+        word |= std::to_integer<size_t>(input[index]) << (index * 8);
+    }
+
+    return word;
+}
+
+}  // namespace
+
+void Codec::Compress(std::span<const std::byte> input, std::vector<std::byte>& output) {
+    CompressBlocks(input);
+
+    size_t size_of_output = output.size();
+    output.resize(size_of_output + size_of_compressed_blocks);
+
+    WriteCompressedBlocks(output.data() + size_of_output);
+}
+
+size_t Codec::Compress(std::span<const std::byte> input, std::span<std::byte> output) {
+    CompressBlocks(input);
+
+    if (size_of_compressed_blocks > output.size()) {
+        throw std::runtime_error("error - output buffer is too small");
+    }
+
+    WriteCompressedBlocks(output.data());
+
+    return size_of_compressed_blocks;
+}
+
+void Codec::Decompress(std::span<const std::byte> input, std::vector<std::byte>& output) {
+    size_t size = ReadSizesOfBlocks(input);
+
+    size_t size_of_output = output.size();
+    output.resize(size_of_output + size);
+
+    DecompressBlocks(input, output.data() + size_of_output);
+}
+
+size_t Codec::Decompress(std::span<const std::byte> input, std::span<std::byte> output) {
+    size_t size = ReadSizesOfBlocks(input);
+
+    if (size > output.size()) {
+        throw std::runtime_error("error - output buffer is too small");
+    }
+
+    DecompressBlocks(input, output.data());
+
+    return size;
+}
+
+size_t Codec::GetMaxCompressedSize(size_t size) const {
+    size_t size_of_block = GetSizeOfBlock();
+    size_t number_of_blocks = (size + size_of_block - 1) / size_of_block;
+
+    // A block which does not get smaller is stored with its type byte.
+    size_t size_of_block_overhead =
+        SIZE_OF_BLOCK_HEADER + 1 + (archiver.block_checksums ? sizeof(uint32_t) : 0);
+
+    return size + number_of_blocks * size_of_block_overhead + 4;
+}
+
+size_t Codec::GetDecompressedSize(std::span<const std::byte> input) {
+    return ReadSizesOfBlocks(input);
+}
+
+size_t Codec::GetSizeOfBlock() const {
+    if (archiver.block_size == 0) {
+        return Archiver::STREAMING_BLOCK_SIZE;
+    }
+
+    return std::min(archiver.block_size, Archiver::MAX_BLOCK_SIZE);
+}
+
+ThreadPool& Codec::GetPool() {
+    size_t number_of_threads = archiver.number_of_threads > 1 ? archiver.number_of_threads : 0;
+
+    if (pool == nullptr || pool->Size() != number_of_threads) {
+        pool = std::make_unique<ThreadPool>(number_of_threads);
+    }
+
+    huffmans.resize(std::max<size_t>(1, number_of_threads));
+
+    return *pool;
+}
+
+void Codec::CompressBlocks(std::span<const std::byte> input) {
+    ThreadPool& pool_of_threads = GetPool();
+
+    const char* data = reinterpret_cast<const char*>(input.data());
+    size_t size_of_block = GetSizeOfBlock();
+    size_t number_of_blocks = (input.size() + size_of_block - 1) / size_of_block;
+    size_t number_of_tasks = std::min(huffmans.size(), number_of_blocks);
+
+    compressed_blocks.resize(number_of_blocks);
+    size_of_input = input.size();
+
+    pool_of_threads.Run(number_of_tasks, [&](size_t task) {
+        for (size_t index = task; index < number_of_blocks; index += number_of_tasks) {
+            size_t offset = index * size_of_block;
+
+            archiver.CompressBlock(data + offset, std::min(size_of_block, input.size() - offset),
+                                   compressed_blocks[index], huffmans[task]);
+        }
+    });
+
+    size_of_compressed_blocks = 4;
+
+    for (const auto& compressed_block : compressed_blocks) {
+        size_of_compressed_blocks += SIZE_OF_BLOCK_HEADER + compressed_block.size();
+    }
+}
+
+void Codec::WriteCompressedBlocks(std::byte* output) const {
+    size_t size_of_block = GetSizeOfBlock();
+    size_t size_left = size_of_input;
+
+    for (const auto& compressed_block : compressed_blocks) {
+        size_t size = std::min(size_of_block, size_left);
+        size_left -= size;
+
+        PutWord(output, size);
+        PutWord(output + 4, compressed_block.size());
+        output += SIZE_OF_BLOCK_HEADER;
+
+        output = std::copy(reinterpret_cast<const std::byte*>(compressed_block.data()),
+                           reinterpret_cast<const std::byte*>(compressed_block.data()) +
+                               compressed_block.size(),
+                           output);
+    }
+
+    PutWord(output, 0);
+}
+
+size_t Codec::ReadSizesOfBlocks(std::span<const std::byte> input) {
+    block_positions.clear();
+
+    size_t position = 0;
+    size_t size = 0;
+
+    while (true) {
+        if (input.size() - position < 4) {
+            throw std::runtime_error("error - unexpected end of file");
+        }
+
+        size_t size_of_block = GetWord(input.data() + position);
+
+        if (size_of_block == 0) {
+            break;
+        }
+
+        if (input.size() - position < SIZE_OF_BLOCK_HEADER) {
+            throw std::runtime_error("error - unexpected end of file");
+        }
+
+        size_t size_of_compressed_block = GetWord(input.data() + position + 4);
+        position += SIZE_OF_BLOCK_HEADER;
+
+        if (size_of_block > Archiver::MAX_BLOCK_SIZE ||
+            size_of_compressed_block > size_of_block + Archiver::MAX_BLOCK_OVERHEAD ||
+            size_of_compressed_block > input.size() - position) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        block_positions.push_back({size, size_of_block, position, size_of_compressed_block});
+
+        position += size_of_compressed_block;
+        size += size_of_block;
+    }
+
+    if (position + 4 != input.size()) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    return size;
+}
+
+void Codec::DecompressBlocks(std::span<const std::byte> input, std::byte* output) {
+    ThreadPool& pool_of_threads = GetPool();
+
+    const char* data = reinterpret_cast<const char*>(input.data());
+    size_t number_of_blocks = block_positions.size();
+    size_t number_of_tasks = std::min(huffmans.size(), number_of_blocks);
+
+    pool_of_threads.Run(number_of_tasks, [&](size_t task) {
+        for (size_t index = task; index < number_of_blocks; index += number_of_tasks) {
+            const BlockPosition& block = block_positions[index];
+
+            archiver.DecompressBlock(data + block.compressed_offset, block.compressed_size,
+                                     reinterpret_cast<char*>(output) + block.offset, block.size,
+                                     huffmans[task]);
+        }
+    });
+}
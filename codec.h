@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "archiver.h"
+
+// Compresses buffers in memory, without files and without the command line. The compressed
+// buffer is a sequence of blocks as (32-bit size, 32-bit compressed size, compressed bytes) up to
+// a zero size, like the blocks of a blocked member. The options are taken from archiver; the
+// codec keeps its threads, tables and buffers between calls, so one codec should be reused for
+// many buffers. A codec must not be used by several threads at once.
+class Codec {
+public:
+    // Appends the compressed input to output.
+    void Compress(std::span<const std::byte> input, std::vector<std::byte>& output);
+
+    // Returns the size of the compressed input written to output.
+    size_t Compress(std::span<const std::byte> input, std::span<std::byte> output);
+
+    // Appends the decompressed input to output.
+    void Decompress(std::span<const std::byte> input, std::vector<std::byte>& output);
+
+    // Returns the size of the decompressed input written to output.
+    size_t Decompress(std::span<const std::byte> input, std::span<std::byte> output);
+
+    // An output buffer of this size is always enough to compress size bytes.
+    size_t GetMaxCompressedSize(size_t size) const;
+
+    size_t GetDecompressedSize(std::span<const std::byte> input);
+
+    size_t GetSizeOfBlock() const;
+
+    ThreadPool& GetPool();
+
+    void CompressBlocks(std::span<const std::byte> input);
+
+    void WriteCompressedBlocks(std::byte* output) const;
+
+    // Reads the sizes of all blocks and returns the size of the decompressed input.
+    size_t ReadSizesOfBlocks(std::span<const std::byte> input);
+
+    void DecompressBlocks(std::span<const std::byte> input, std::byte* output);
+
+    const static size_t SIZE_OF_BLOCK_HEADER;
+
+    Archiver archiver;
+
+    std::unique_ptr<ThreadPool> pool;
+    // One table for every task, so that a task reuses the memory of its previous blocks.
+    std::vector<Huffman> huffmans;
+
+    std::vector<std::vector<char>> compressed_blocks;
+    size_t size_of_input = 0;
+    size_t size_of_compressed_blocks = 0;
+
+    struct BlockPosition {
+        size_t offset = 0;
+        size_t size = 0;
+        size_t compressed_offset = 0;
+        size_t compressed_size = 0;
+    };
+
+    std::vector<BlockPosition> block_positions;
+};
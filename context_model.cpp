@@ -0,0 +1,183 @@
+#include "context_model.h"
+
+#include <cmath>
+#include <limits>
+
+const size_t ContextModel::MAX_NUMBER_OF_CONTEXTS = 16;
+const size_t ContextModel::NUMBER_OF_BYTES = 256;
+const size_t ContextModel::NUMBER_OF_CLUSTERING_ROUNDS = 4;
+const size_t ContextModel::MIN_SIZE_OF_BLOCK = (1 << 12);
+const unsigned char ContextModel::FIRST_PREVIOUS_BYTE = 0;
+
+ContextModel::ContextModel(size_t max_number_of_contexts)
+    : max_number_of_contexts(max_number_of_contexts) {
+    if (max_number_of_contexts < 1 || max_number_of_contexts > MAX_NUMBER_OF_CONTEXTS) {
+        throw std::runtime_error("error - wrong number of contexts");
+    }
+}
+
+void ContextModel::Build(const char* data, size_t size) {
+    frequencies_after_byte.assign(NUMBER_OF_BYTES * NUMBER_OF_BYTES, 0);
+    number_after_byte.assign(NUMBER_OF_BYTES, 0);
+
+    unsigned char previous_byte = FIRST_PREVIOUS_BYTE;
+
+    for (size_t index = 0; index < size; ++index) {
+        unsigned char byte = static_cast<unsigned char>(data[index]);
+
+        ++frequencies_after_byte[previous_byte * NUMBER_OF_BYTES + byte];
+        previous_byte = byte;
+    }
+
+    std::vector<size_t> previous_bytes;
+    std::vector<double> size_of_own_code(NUMBER_OF_BYTES);
+
+    for (size_t byte = 0; byte < NUMBER_OF_BYTES; ++byte) {
+        for (size_t next_byte = 0; next_byte < NUMBER_OF_BYTES; ++next_byte) {
+            number_after_byte[byte] += frequencies_after_byte[byte * NUMBER_OF_BYTES + next_byte];
+        }
+
+        if (number_after_byte[byte] == 0) {
+            continue;
+        }
+
+        previous_bytes.push_back(byte);
+
+        for (size_t next_byte = 0; next_byte < NUMBER_OF_BYTES; ++next_byte) {
+            double frequency =
+                static_cast<double>(frequencies_after_byte[byte * NUMBER_OF_BYTES + next_byte]);
+
+            if (frequency > 0) {
+                size_of_own_code[byte] +=
+                    frequency * std::log2(static_cast<double>(number_after_byte[byte]) / frequency);
+            }
+        }
+    }
+
+    const size_t number_of_contexts = std::min(max_number_of_contexts, previous_bytes.size());
+
+    // Farthest first: the first context is the one of the most frequent byte, every next one is
+    // the one of the byte whose code by the contexts chosen before is the longest over its own.
+    std::vector<std::vector<size_t>> lengths_of_contexts;
+    std::vector<size_t> size_of_code(NUMBER_OF_BYTES, std::numeric_limits<size_t>::max());
+
+    std::vector<bool> is_chosen(NUMBER_OF_BYTES);
+    size_t farthest_byte =
+        std::max_element(number_after_byte.begin(), number_after_byte.end()) -
+        number_after_byte.begin();
+
+    while (lengths_of_contexts.size() < number_of_contexts) {
+        lengths_of_contexts.push_back(GetLengthsOfCodes({farthest_byte}));
+        is_chosen[farthest_byte] = true;
+
+        double max_excess = 0;
+
+        for (auto byte : previous_bytes) {
+            size_of_code[byte] =
+                std::min(size_of_code[byte], GetSizeOfCode(byte, lengths_of_contexts.back()));
+
+            double excess = static_cast<double>(size_of_code[byte]) - size_of_own_code[byte];
+
+            if (!is_chosen[byte] && excess > max_excess) {
+                max_excess = excess;
+                farthest_byte = byte;
+            }
+        }
+
+        if (max_excess == 0) {
+            break;
+        }
+    }
+
+    // Then every context is built again from the bytes it codes shortest, a few times.
+    context_of_byte.assign(NUMBER_OF_BYTES, 0);
+    std::vector<std::vector<size_t>> clusters;
+
+    for (size_t round = 0; round < NUMBER_OF_CLUSTERING_ROUNDS; ++round) {
+        clusters.assign(lengths_of_contexts.size(), {});
+
+        for (auto byte : previous_bytes) {
+            size_t best_context = 0;
+            size_t best_size = std::numeric_limits<size_t>::max();
+
+            for (size_t context = 0; context < lengths_of_contexts.size(); ++context) {
+                size_t size_of_context = GetSizeOfCode(byte, lengths_of_contexts[context]);
+
+                if (size_of_context < best_size) {
+                    best_size = size_of_context;
+                    best_context = context;
+                }
+            }
+
+            clusters[best_context].push_back(byte);
+        }
+
+        clusters.erase(std::remove_if(clusters.begin(), clusters.end(),
+                                      [](const auto& cluster) { return cluster.empty(); }),
+                       clusters.end());
+
+        lengths_of_contexts.clear();
+
+        for (const auto& cluster : clusters) {
+            lengths_of_contexts.push_back(GetLengthsOfCodes(cluster));
+        }
+    }
+
+    frequencies_of_contexts.assign(clusters.size(), std::vector<size_t>(Huffman::SYMBOLS_COUNT));
+
+    for (size_t context = 0; context < clusters.size(); ++context) {
+        std::vector<size_t>& frequencies = frequencies_of_contexts[context];
+
+        for (auto byte : clusters[context]) {
+            context_of_byte[byte] = static_cast<uint8_t>(context);
+
+            for (size_t next_byte = 0; next_byte < NUMBER_OF_BYTES; ++next_byte) {
+                frequencies[next_byte] +=
+                    frequencies_after_byte[byte * NUMBER_OF_BYTES + next_byte];
+            }
+        }
+
+        // A table of codes has at least two symbols.
+        if (std::count_if(frequencies.begin(), frequencies.end(),
+                          [](size_t frequency) { return frequency > 0; }) < 2) {
+            ++frequencies[frequencies[0] == 0 ? 0 : 1];
+        }
+    }
+}
+
+size_t ContextModel::GetSizeOfCode(size_t previous_byte,
+                                   const std::vector<size_t>& length_of_code) const {
+    const size_t* frequencies = frequencies_after_byte.data() + previous_byte * NUMBER_OF_BYTES;
+    size_t size = 0;
+
+    for (size_t byte = 0; byte < NUMBER_OF_BYTES; ++byte) {
+        size += frequencies[byte] * length_of_code[byte];
+    }
+
+    return size;
+}
+
+std::vector<size_t> ContextModel::GetLengthsOfCodes(
+    const std::vector<size_t>& previous_bytes) const {
+    // Every byte gets a code, so that a byte never seen after these ones is not free.
+    std::vector<size_t> frequencies(Huffman::SYMBOLS_COUNT);
+
+    for (size_t byte = 0; byte < NUMBER_OF_BYTES; ++byte) {
+        frequencies[byte] = 1;
+    }
+
+    for (auto previous_byte : previous_bytes) {
+        for (size_t byte = 0; byte < NUMBER_OF_BYTES; ++byte) {
+            frequencies[byte] += frequencies_after_byte[previous_byte * NUMBER_OF_BYTES + byte];
+        }
+    }
+
+    Huffman huffman(frequencies);
+    std::vector<size_t> length_of_code(NUMBER_OF_BYTES);
+
+    for (size_t byte = 0; byte < NUMBER_OF_BYTES; ++byte) {
+        length_of_code[byte] = huffman.code_of_symbol[byte].length;
+    }
+
+    return length_of_code;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+
+#include "huffman.h"
+
+// Codes every byte of a block by the table of the context of the byte before it. Bytes whose next
+// bytes are alike share a context, which is found by k-means over the bytes with the size of their
+// code as the distance.
+class ContextModel {
+public:
+    const static size_t MAX_NUMBER_OF_CONTEXTS;
+    const static size_t NUMBER_OF_BYTES;
+    const static size_t NUMBER_OF_CLUSTERING_ROUNDS;
+    // Smaller blocks do not pay for the contexts and their tables.
+    const static size_t MIN_SIZE_OF_BLOCK;
+    // The context of the first byte of a block is the one of FIRST_PREVIOUS_BYTE.
+    const static unsigned char FIRST_PREVIOUS_BYTE;
+
+    ContextModel(size_t max_number_of_contexts);
+
+    // Counts the bytes after every byte of the block and clusters them into contexts.
+    void Build(const char* data, size_t size);
+
+    // The number of bits of the bytes after previous_byte coded by the lengths of codes.
+    size_t GetSizeOfCode(size_t previous_byte, const std::vector<size_t>& length_of_code) const;
+
+    // Lengths of the codes of the bytes after previous_bytes, every byte getting a code.
+    std::vector<size_t> GetLengthsOfCodes(const std::vector<size_t>& previous_bytes) const;
+
+    size_t max_number_of_contexts;
+
+    // The next bytes of every byte, NUMBER_OF_BYTES counts after each one.
+    std::vector<size_t> frequencies_after_byte;
+    std::vector<size_t> number_after_byte;
+
+    std::vector<uint8_t> context_of_byte;
+    // Frequencies of bytes in every context, in Huffman::SYMBOLS_COUNT counts each.
+    std::vector<std::vector<size_t>> frequencies_of_contexts;
+};
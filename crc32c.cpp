@@ -0,0 +1,117 @@
+#include "crc32c.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CRC32C_WITH_SSE42
+#include <nmmintrin.h>
+#endif
+
+const uint32_t Crc32c::POLYNOMIAL = 0x82F63B78;
+const size_t Crc32c::NUMBER_OF_TABLES = 8;
+
+uint32_t Crc32c::Extend(uint32_t crc, const char* data, size_t size) {
+    static const bool has_sse42 = HasSse42();
+
+    if (has_sse42) {
+        return ExtendWithSse42(crc, data, size);
+    }
+
+    return ExtendWithTables(crc, data, size);
+}
+
+uint32_t Crc32c::ExtendWithTables(uint32_t crc, const char* data, size_t size) {
+    static const std::vector<std::vector<uint32_t>> tables = BuildTables();
+
+    crc = ~crc;
+
+    size_t index = 0;
+
+    for (; index + 8 <= size; index += 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, data + index, sizeof(low));
+        std::memcpy(&high, data + index + 4, sizeof(high));
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        low = __builtin_bswap32(low);
+        high = __builtin_bswap32(high);
+#endif
+
+        low ^= crc;
+
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+              tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^ tables[3][high & 0xFF] ^
+              tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^
+              tables[0][high >> 24];
+    }
+
+    for (; index < size; ++index) {
+        crc = tables[0][(crc ^ static_cast<unsigned char>(data[index])) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+std::vector<std::vector<uint32_t>> Crc32c::BuildTables() {
+    std::vector<std::vector<uint32_t>> tables(NUMBER_OF_TABLES, std::vector<uint32_t>(256));
+
+    for (uint32_t value = 0; value < 256; ++value) {
+        uint32_t crc = value;
+
+        for (size_t bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ POLYNOMIAL : crc >> 1;
+        }
+
+        tables[0][value] = crc;
+    }
+
+    for (size_t table = 1; table < NUMBER_OF_TABLES; ++table) {
+        for (size_t value = 0; value < 256; ++value) {
+            uint32_t previous = tables[table - 1][value];
+
+            tables[table][value] = tables[0][previous & 0xFF] ^ (previous >> 8);
+        }
+    }
+
+    return tables;
+}
+
+#ifdef CRC32C_WITH_SSE42
+
+__attribute__((target("sse4.2"))) uint32_t Crc32c::ExtendWithSse42(uint32_t crc,
+                                                                   const char* data,
+                                                                   size_t size) {
+    uint64_t state = ~crc;
+
+    size_t index = 0;
+
+    for (; index + 8 <= size; index += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + index, sizeof(word));
+
+        state = _mm_crc32_u64(state, word);
+    }
+
+    uint32_t short_state = static_cast<uint32_t>(state);
+
+    for (; index < size; ++index) {
+        short_state = _mm_crc32_u8(short_state, static_cast<unsigned char>(data[index]));
+    }
+
+    return ~short_state;
+}
+
+bool Crc32c::HasSse42() {
+    return __builtin_cpu_supports("sse4.2");
+}
+
+#else
+
+uint32_t Crc32c::ExtendWithSse42(uint32_t crc, const char* data, size_t size) {
+    return ExtendWithTables(crc, data, size);
+}
+
+bool Crc32c::HasSse42() {
+    return false;
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// CRC-32C (Castagnoli) of byte buffers. Extend picks the crc32 instruction of SSE 4.2 when the
+// processor has it.
+class Crc32c {
+public:
+    // Reflected.
+    const static uint32_t POLYNOMIAL;
+    const static size_t NUMBER_OF_TABLES;
+
+    // Returns the checksum of the bytes checksummed by crc followed by data; the checksum of no
+    // bytes is 0.
+    static uint32_t Extend(uint32_t crc, const char* data, size_t size);
+
+    // Slicing by eight: every table turns a byte into its remainder shifted by one more byte.
+    static uint32_t ExtendWithTables(uint32_t crc, const char* data, size_t size);
+
+    // Must be called only when HasSse42() is true.
+    static uint32_t ExtendWithSse42(uint32_t crc, const char* data, size_t size);
+
+    static bool HasSse42();
+
+    static std::vector<std::vector<uint32_t>> BuildTables();
+};
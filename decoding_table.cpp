@@ -0,0 +1,171 @@
+#include "decoding_table.h"
+
+const size_t DecodingTable::LOOKUP_BITS = 10;
+const size_t DecodingTable::MAX_LOOKUP_BITS = 16;
+const size_t DecodingTable::MAX_TABLE_CODE_SIZE = 20;
+const size_t DecodingTable::MAX_CODE_SIZE = 56;
+const int DecodingTable::INVALID_SYMBOL = -1;
+const int DecodingTable::LONG_CODE_SYMBOL = -2;
+const int DecodingTable::LINK_SYMBOL = -3;
+
+void DecodingTable::Build(const std::vector<int>& order_of_symbols,
+                          const std::vector<int>& number_of_codes_with_size_in_header,
+                          size_t lookup_bits_of_table) {
+    if (order_of_symbols.empty() || number_of_codes_with_size_in_header.size() < 2 ||
+        lookup_bits_of_table < LOOKUP_BITS || lookup_bits_of_table > MAX_LOOKUP_BITS) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    lookup_bits = lookup_bits_of_table;
+
+    max_symbol_code_size = number_of_codes_with_size_in_header.size() - 1;
+
+    if (max_symbol_code_size > MAX_CODE_SIZE) {
+        throw std::runtime_error("error - too long code in archive file");
+    }
+
+    symbols = order_of_symbols;
+    number_of_codes_with_size.assign(number_of_codes_with_size_in_header.begin(),
+                                     number_of_codes_with_size_in_header.end());
+
+    std::vector<uint64_t> code_of_index(symbols.size());
+    std::vector<size_t> length_of_index(symbols.size());
+
+    uint64_t code = 0;
+    size_t index = 0;
+
+    for (size_t length = 1; length <= max_symbol_code_size; ++length) {
+        for (uint64_t counter = 0; counter < number_of_codes_with_size[length]; ++counter) {
+            if (index == symbols.size() || code >= (static_cast<uint64_t>(1) << length)) {
+                throw std::runtime_error("error - wrong data in archive file");
+            }
+
+            code_of_index[index] = ReverseBits(code, length);
+            length_of_index[index] = length;
+            ++index;
+            ++code;
+        }
+
+        code <<= 1;
+    }
+
+    if (index != symbols.size()) {
+        throw std::runtime_error("error - wrong data in archive file");
+    }
+
+    const uint64_t lookup_mask = (static_cast<uint64_t>(1) << lookup_bits) - 1;
+
+    primary_table.assign(static_cast<size_t>(1) << lookup_bits, Entry());
+    secondary_table.clear();
+
+    std::vector<size_t> max_length_with_prefix(primary_table.size());
+
+    for (index = 0; index < symbols.size(); ++index) {
+        if (length_of_index[index] > lookup_bits) {
+            size_t prefix = code_of_index[index] & lookup_mask;
+            max_length_with_prefix[prefix] =
+                std::max(max_length_with_prefix[prefix], length_of_index[index]);
+        }
+    }
+
+    for (size_t prefix = 0; prefix < primary_table.size(); ++prefix) {
+        if (max_length_with_prefix[prefix] == 0) {
+            continue;
+        }
+
+        Entry& link = primary_table[prefix];
+        link.symbol = LINK_SYMBOL;
+        link.sub_bits = std::min(max_length_with_prefix[prefix], MAX_TABLE_CODE_SIZE) - lookup_bits;
+        link.offset = secondary_table.size();
+
+        secondary_table.resize(secondary_table.size() + (static_cast<size_t>(1) << link.sub_bits));
+    }
+
+    for (index = 0; index < symbols.size(); ++index) {
+        size_t length = length_of_index[index];
+        uint64_t reversed_code = code_of_index[index];
+
+        Entry entry;
+        entry.symbol = static_cast<int16_t>(symbols[index]);
+        entry.length = static_cast<uint8_t>(length);
+
+        if (length <= lookup_bits) {
+            for (uint64_t filler = reversed_code; filler < primary_table.size();
+                 filler += static_cast<uint64_t>(1) << length) {
+                primary_table[filler] = entry;
+            }
+            continue;
+        }
+
+        const Entry& link = primary_table[reversed_code & lookup_mask];
+        uint64_t rest_of_code = reversed_code >> lookup_bits;
+        size_t rest_length = length - lookup_bits;
+
+        if (rest_length > link.sub_bits) {
+            uint64_t slot = rest_of_code & ((static_cast<uint64_t>(1) << link.sub_bits) - 1);
+            secondary_table[link.offset + slot].symbol = LONG_CODE_SYMBOL;
+            continue;
+        }
+
+        for (uint64_t filler = rest_of_code; filler < (static_cast<uint64_t>(1) << link.sub_bits);
+             filler += static_cast<uint64_t>(1) << rest_length) {
+            secondary_table[link.offset + filler] = entry;
+        }
+    }
+}
+
+int DecodingTable::Decode(uint64_t next_bits, size_t available, size_t& length) const {
+    const uint64_t lookup_mask = (static_cast<uint64_t>(1) << lookup_bits) - 1;
+    const Entry* entry = &primary_table[next_bits & lookup_mask];
+
+    if (entry->symbol == LINK_SYMBOL) {
+        uint64_t slot =
+            (next_bits >> lookup_bits) & ((static_cast<uint64_t>(1) << entry->sub_bits) - 1);
+        entry = &secondary_table[entry->offset + slot];
+    }
+
+    if (entry->symbol == LONG_CODE_SYMBOL) {
+        return LONG_CODE_SYMBOL;
+    }
+
+    if (entry->symbol == INVALID_SYMBOL || entry->length > available) {
+        return INVALID_SYMBOL;
+    }
+
+    length = entry->length;
+    return entry->symbol;
+}
+
+int DecodingTable::DecodeLongCode(uint64_t next_bits, size_t available, size_t& length) const {
+    uint64_t code = 0;
+    uint64_t first = 0;
+    uint64_t index = 0;
+
+    for (size_t current_length = 1;
+         current_length <= max_symbol_code_size && current_length <= available; ++current_length) {
+        code |= (next_bits >> (current_length - 1)) & 1;
+
+        uint64_t count = number_of_codes_with_size[current_length];
+
+        if (code >= first && code - first < count) {
+            length = current_length;
+            return symbols[index + code - first];
+        }
+
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+
+    return INVALID_SYMBOL;
+}
+
+uint64_t DecodingTable::ReverseBits(uint64_t code, size_t length) {
+    uint64_t reversed_code = 0;
+
+    for (size_t index = 0; index < length; ++index) {
+        reversed_code = (reversed_code << 1) | ((code >> index) & 1);
+    }
+
+    return reversed_code;
+}
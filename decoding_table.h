@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+class DecodingTable {
+public:
+    const static size_t LOOKUP_BITS;
+    const static size_t MAX_LOOKUP_BITS;
+    const static size_t MAX_TABLE_CODE_SIZE;
+    const static size_t MAX_CODE_SIZE;
+    const static int INVALID_SYMBOL;
+    const static int LONG_CODE_SYMBOL;
+    const static int LINK_SYMBOL;
+
+    struct Entry {
+        int16_t symbol = -1;
+        uint8_t length = 0;
+        uint8_t sub_bits = 0;
+        uint32_t offset = 0;
+    };
+
+    // Codes up to lookup_bits long are decoded by one lookup in the primary table.
+    void Build(const std::vector<int>& order_of_symbols,
+               const std::vector<int>& number_of_codes_with_size,
+               size_t lookup_bits = LOOKUP_BITS);
+
+    // next_bits holds the next available bits of the stream, the first one in the lowest bit.
+    // Codes longer than MAX_TABLE_CODE_SIZE give LONG_CODE_SYMBOL and go to DecodeLongCode.
+    int Decode(uint64_t next_bits, size_t available, size_t& length) const;
+
+    int DecodeLongCode(uint64_t next_bits, size_t available, size_t& length) const;
+
+    static uint64_t ReverseBits(uint64_t code, size_t length);
+
+    size_t max_symbol_code_size = 0;
+    size_t lookup_bits = LOOKUP_BITS;
+
+    std::vector<Entry> primary_table;
+    std::vector<Entry> secondary_table;
+    std::vector<int> symbols;
+    std::vector<uint64_t> number_of_codes_with_size;
+};
@@ -0,0 +1,166 @@
+#include "histogram.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HISTOGRAM_WITH_AVX2
+#include <immintrin.h>
+#endif
+
+const size_t Histogram::NUMBER_OF_BYTE_VALUES = 256;
+const size_t Histogram::NUMBER_OF_SUB_HISTOGRAMS = 8;
+const size_t Histogram::MIN_SIZE_FOR_SUB_HISTOGRAMS = (1 << 12);
+const size_t Histogram::MAX_CHUNK_SIZE = (1 << 30);
+const size_t Histogram::SIZE_OF_SEGMENT = (1 << 10);
+
+namespace {
+
+// Sub-histograms have 32-bit counters, which cannot overflow within MAX_CHUNK_SIZE bytes.
+using SubHistograms = uint32_t[8][256];
+
+void AddSubHistograms(const SubHistograms& counts, std::vector<size_t>& frequencies) {
+    for (size_t value = 0; value < Histogram::NUMBER_OF_BYTE_VALUES; ++value) {
+        size_t frequency = 0;
+
+        for (size_t table = 0; table < Histogram::NUMBER_OF_SUB_HISTOGRAMS; ++table) {
+            frequency += counts[table][value];
+        }
+
+        frequencies[value] += frequency;
+    }
+}
+
+void CountWord(uint64_t word, SubHistograms& counts) {
+    ++counts[0][word & 0xFF];
+    ++counts[1][(word >> 8) & 0xFF];
+    ++counts[2][(word >> 16) & 0xFF];
+    ++counts[3][(word >> 24) & 0xFF];
+    ++counts[4][(word >> 32) & 0xFF];
+    ++counts[5][(word >> 40) & 0xFF];
+    ++counts[6][(word >> 48) & 0xFF];
+    ++counts[7][word >> 56];
+}
+
+// Counts the 16-byte words of data and returns the number of bytes counted.
+size_t CountWords(const char* data, size_t size, SubHistograms& counts) {
+    size_t index = 0;
+
+    for (; index + 16 <= size; index += 16) {
+        uint64_t first_word;
+        uint64_t second_word;
+        std::memcpy(&first_word, data + index, sizeof(first_word));
+        std::memcpy(&second_word, data + index + 8, sizeof(second_word));
+
+        CountWord(first_word, counts);
+        CountWord(second_word, counts);
+    }
+
+    return index;
+}
+
+}  // namespace
+
+void Histogram::Count(const char* data, size_t size, std::vector<size_t>& frequencies) {
+    static const bool has_avx2 = HasAvx2();
+
+    if (size < MIN_SIZE_FOR_SUB_HISTOGRAMS) {
+        CountWithOneTable(data, size, frequencies);
+    } else if (has_avx2) {
+        CountWithAvx2(data, size, frequencies);
+    } else {
+        CountWithSubHistograms(data, size, frequencies);
+    }
+}
+
+void Histogram::CountWithOneTable(const char* data, size_t size,
+                                  std::vector<size_t>& frequencies) {
+    for (size_t index = 0; index < size; ++index) {
+        frequencies[static_cast<unsigned char>(data[index])]++;
+    }
+}
+
+void Histogram::CountWithSubHistograms(const char* data, size_t size,
+                                       std::vector<size_t>& frequencies) {
+    while (size > 0) {
+        size_t size_of_chunk = std::min(size, MAX_CHUNK_SIZE);
+        size_t index = 0;
+
+        SubHistograms counts = {};
+
+        index = CountWords(data, size_of_chunk, counts);
+
+        AddSubHistograms(counts, frequencies);
+        CountWithOneTable(data + index, size_of_chunk - index, frequencies);
+
+        data += size_of_chunk;
+        size -= size_of_chunk;
+    }
+}
+
+#ifdef HISTOGRAM_WITH_AVX2
+
+namespace {
+
+__attribute__((target("avx2"))) bool IsRun(const char* data) {
+    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    __m256i first_bytes = _mm256_set1_epi8(data[0]);
+
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, first_bytes)) == -1;
+}
+
+// Counts a segment which starts with a run 32 bytes at a time, adding runs of 32 equal bytes at
+// once.
+__attribute__((target("avx2"))) void CountSegmentWithRuns(const char* data, size_t size,
+                                                          SubHistograms& counts) {
+    for (size_t index = 0; index < size; index += 32) {
+        if (IsRun(data + index)) {
+            counts[0][static_cast<unsigned char>(data[index])] += 32;
+        } else {
+            CountWords(data + index, 32, counts);
+        }
+    }
+}
+
+}  // namespace
+
+// Checking every 32 bytes for a run costs more than it saves on mixed data, so only segments that
+// start with a run are checked further and the rest are counted like CountWithSubHistograms.
+__attribute__((target("avx2"))) void Histogram::CountWithAvx2(const char* data, size_t size,
+                                                              std::vector<size_t>& frequencies) {
+    while (size > 0) {
+        size_t size_of_chunk = std::min(size, MAX_CHUNK_SIZE);
+        size_t index = 0;
+
+        SubHistograms counts = {};
+
+        for (; index + SIZE_OF_SEGMENT <= size_of_chunk; index += SIZE_OF_SEGMENT) {
+            if (IsRun(data + index)) {
+                CountSegmentWithRuns(data + index, SIZE_OF_SEGMENT, counts);
+            } else {
+                CountWords(data + index, SIZE_OF_SEGMENT, counts);
+            }
+        }
+
+        index += CountWords(data + index, size_of_chunk - index, counts);
+
+        AddSubHistograms(counts, frequencies);
+        CountWithOneTable(data + index, size_of_chunk - index, frequencies);
+
+        data += size_of_chunk;
+        size -= size_of_chunk;
+    }
+}
+
+bool Histogram::HasAvx2() {
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+void Histogram::CountWithAvx2(const char* data, size_t size, std::vector<size_t>& frequencies) {
+    CountWithSubHistograms(data, size, frequencies);
+}
+
+bool Histogram::HasAvx2() {
+    return false;
+}
+
+#endif
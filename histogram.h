@@ -0,0 +1,33 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Byte histograms of raw buffers. Count picks the fastest kernel the processor supports.
+class Histogram {
+public:
+    const static size_t NUMBER_OF_BYTE_VALUES;
+    const static size_t NUMBER_OF_SUB_HISTOGRAMS;
+    const static size_t MIN_SIZE_FOR_SUB_HISTOGRAMS;
+    const static size_t MAX_CHUNK_SIZE;
+    const static size_t SIZE_OF_SEGMENT;
+
+    // Adds the number of occurrences of every byte of data to frequencies, which must have at
+    // least NUMBER_OF_BYTE_VALUES entries.
+    static void Count(const char* data, size_t size, std::vector<size_t>& frequencies);
+
+    static void CountWithOneTable(const char* data, size_t size, std::vector<size_t>& frequencies);
+
+    // Runs of equal bytes increment different counters, so they do not wait for each other's
+    // stores.
+    static void CountWithSubHistograms(const char* data, size_t size,
+                                       std::vector<size_t>& frequencies);
+
+    // Counts like CountWithSubHistograms, but adds runs of 32 equal bytes at once. Must be called
+    // only when HasAvx2() is true.
+    static void CountWithAvx2(const char* data, size_t size, std::vector<size_t>& frequencies);
+
+    static bool HasAvx2();
+};
@@ -6,157 +6,192 @@ const size_t Huffman::ALPHABET_SIZE = 9;
 const int Huffman::FILENAME_END = 256;
 const int Huffman::ONE_MORE_FILE = 257;
 const int Huffman::ARCHIVE_END = 258;
+const size_t Huffman::MAX_CODE_SIZE = 32;
+const size_t Huffman::MIN_CODE_SIZE_LIMIT = 9;
+const size_t Huffman::MAX_NUMBER_OF_VERTEXES = 2 * Huffman::SYMBOLS_COUNT;
+
+namespace {
+
+// Decodes count bytes of every stream to its part. The states of the readers are kept in locals,
+// which the stores to the parts cannot alias, and are refilled for a group of symbols at once, so
+// only codes that are not in the primary table go back to the readers.
+template <size_t NumberOfStreams>
+void DecodeParts(const Huffman& huffman, BitReader* const* readers, char* const* parts,
+                 size_t count) {
+    const DecodingTable::Entry* primary_table = huffman.decoding_table.primary_table.data();
+    const uint64_t lookup_mask = huffman.decoding_table.primary_table.size() - 1;
+    const size_t lookup_bits = huffman.decoding_table.lookup_bits;
+    const size_t symbols_per_refill = BitReader::MAX_PEEK_BITS / lookup_bits;
+
+    const char* data[NumberOfStreams];
+    size_t position[NumberOfStreams];
+    size_t end[NumberOfStreams];
+    uint64_t bit_buffer[NumberOfStreams];
+    size_t bits_in_buffer[NumberOfStreams];
+
+    auto load = [&](size_t stream) {
+        data[stream] = readers[stream]->data_;
+        position[stream] = readers[stream]->position_;
+        end[stream] = readers[stream]->end_;
+        bit_buffer[stream] = readers[stream]->bit_buffer_;
+        bits_in_buffer[stream] = readers[stream]->bits_in_buffer_;
+    };
 
-Huffman::Huffman(const std::vector<size_t>& frequencies_of_alphabet) {
-    code_of_symbol = std::vector<std::vector<bool>>(SYMBOLS_COUNT);
+    auto save = [&](size_t stream) {
+        readers[stream]->position_ = position[stream];
+        readers[stream]->bit_buffer_ = bit_buffer[stream];
+        readers[stream]->bits_in_buffer_ = bits_in_buffer[stream];
+    };
 
-    Vertex* root = RunHuffman(frequencies_of_alphabet);
+    for (size_t stream = 0; stream < NumberOfStreams; ++stream) {
+        load(stream);
+    }
 
-    std::vector<std::vector<bool>> new_code_of_symbol = GetNewCodeOfSymbols(root);
+    for (size_t index = 0; index < count;) {
+        for (size_t stream = 0; stream < NumberOfStreams; ++stream) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if (position[stream] + sizeof(uint64_t) <= end[stream] &&
+                bits_in_buffer[stream] < sizeof(uint64_t) * 8) {
+                uint64_t word;
+                std::memcpy(&word, data[stream] + position[stream], sizeof(word));
+
+                size_t number_of_bytes = (63 - bits_in_buffer[stream]) / 8;
+
+                bit_buffer[stream] |= word << bits_in_buffer[stream];
+                bits_in_buffer[stream] += number_of_bytes * 8;
+                bit_buffer[stream] &= (static_cast<uint64_t>(1) << bits_in_buffer[stream]) - 1;
+                position[stream] += number_of_bytes;
+                continue;
+            }
+#endif
 
-    size_t number_of_symbols = GetNumberOfSymbols(frequencies_of_alphabet);
+            save(stream);
+            readers[stream]->Refill();
+            load(stream);
+        }
 
-    order_of_symbols = std::vector<int>(SYMBOLS_COUNT);
+        size_t end_of_group = std::min(count, index + symbols_per_refill);
 
-    std::iota(order_of_symbols.begin(), order_of_symbols.end(), 0);
+        for (; index < end_of_group; ++index) {
+            for (size_t stream = 0; stream < NumberOfStreams; ++stream) {
+                const DecodingTable::Entry& entry =
+                    primary_table[bit_buffer[stream] & lookup_mask];
 
-    std::sort(order_of_symbols.begin(), order_of_symbols.end(), [&](int a, int b) {
-        if (frequencies_of_alphabet[b] == 0) {
-            return frequencies_of_alphabet[a] != 0;
-        }
-
-        if (frequencies_of_alphabet[a] == 0) {
-            return false;
-        }
+                if (entry.symbol >= 0 && entry.symbol < Huffman::FILENAME_END &&
+                    entry.length <= bits_in_buffer[stream]) {
+                    parts[stream][index] = static_cast<char>(entry.symbol);
+                    bit_buffer[stream] >>= entry.length;
+                    bits_in_buffer[stream] -= entry.length;
+                    continue;
+                }
 
-        if (new_code_of_symbol[a].size() != new_code_of_symbol[b].size()) {
-            return new_code_of_symbol[a].size() < new_code_of_symbol[b].size();
+                save(stream);
+                parts[stream][index] = huffman.DecodeNextByte(*readers[stream]);
+                load(stream);
+            }
         }
+    }
 
-        return new_code_of_symbol[a] < new_code_of_symbol[b];
-    });
-
-    NormalizeCodeOfSymbols(frequencies_of_alphabet, new_code_of_symbol, number_of_symbols);
+    for (size_t stream = 0; stream < NumberOfStreams; ++stream) {
+        save(stream);
+    }
 }
 
-Huffman::Huffman(const char* file_name) {
-    Reader reader(file_name);
-
-    std::deque<bool>& bits_of_file = reader.bits_of_file_;
-
-    while (NUMBER_OF_BITS_IN_BYTE < bits_of_file.size()) {
-        size_t number_of_symbols = GetValueOfNextLengthBits(reader, bits_of_file, ALPHABET_SIZE);
-        reader.DeleteUselessBitsAtTheBeginning(ALPHABET_SIZE);
+}  // namespace
 
-        GetOrderOfSymbols(reader, bits_of_file, number_of_symbols);
+Huffman::Huffman(const std::vector<size_t>& frequencies_of_alphabet, size_t max_code_size) {
+    Build(frequencies_of_alphabet, max_code_size);
+}
 
-        GetCodeOfSymbols(reader, bits_of_file, number_of_symbols);
+Huffman::Huffman() {
+}
 
-        std::string next_file_name;
+void Huffman::Build(const std::vector<size_t>& frequencies_of_alphabet, size_t max_code_size) {
+    if (max_code_size < MIN_CODE_SIZE_LIMIT || max_code_size > MAX_CODE_SIZE) {
+        throw std::runtime_error("error - wrong limit of code size");
+    }
 
-        while (true) {
-            size_t next_length = FindLengthOfNextCode(reader, bits_of_file);
-            int next_value = FindValueOfNextCode(reader, bits_of_file);
+    std::vector<size_t> length_of_code = GetLengthsOfCodes(RunHuffman(frequencies_of_alphabet));
 
-            if (next_value == FILENAME_END) {
-                break;
-            }
-
-            next_file_name += TransformIntToChar(next_value);
+    if (*std::max_element(length_of_code.begin(), length_of_code.end()) > max_code_size) {
+        length_of_code = GetLimitedLengthsOfCodes(frequencies_of_alphabet, max_code_size);
+    }
 
-            reader.DeleteUselessBitsAtTheBeginning(next_length);
-        }
+    size_t number_of_symbols = GetNumberOfSymbols(frequencies_of_alphabet);
 
-        {
-            size_t next_length = FindLengthOfNextCode(reader, bits_of_file);
-            int next_value = FindValueOfNextCode(reader, bits_of_file);
+    order_of_symbols.resize(SYMBOLS_COUNT);
 
-            if (next_value != FILENAME_END) {
-                throw std::runtime_error("error - wrong data in archive file");
-            }
+    std::iota(order_of_symbols.begin(), order_of_symbols.end(), 0);
 
-            reader.DeleteUselessBitsAtTheBeginning(next_length);
+    std::sort(order_of_symbols.begin(), order_of_symbols.end(), [&](int a, int b) {
+        if (frequencies_of_alphabet[b] == 0) {
+            return frequencies_of_alphabet[a] != 0;
         }
 
-        Writer writer(next_file_name);
-
-        while (true) {
-            size_t next_length = FindLengthOfNextCode(reader, bits_of_file);
-            int next_value = FindValueOfNextCode(reader, bits_of_file);
-
-            if (next_value == ARCHIVE_END || next_value == ONE_MORE_FILE) {
-                break;
-            }
-
-            writer.WriteCharacter(TransformIntToChar(next_value));
-
-            reader.DeleteUselessBitsAtTheBeginning(next_length);
+        if (frequencies_of_alphabet[a] == 0) {
+            return false;
         }
 
-        size_t next_length = FindLengthOfNextCode(reader, bits_of_file);
-        int next_value = FindValueOfNextCode(reader, bits_of_file);
+        return length_of_code[a] < length_of_code[b];
+    });
 
-        if (next_value != ARCHIVE_END && next_value != ONE_MORE_FILE) {
-            throw std::runtime_error("error - wrong data in archive file");
-        }
+    NormalizeCodeOfSymbols(frequencies_of_alphabet, length_of_code, number_of_symbols);
+}
 
-        if (next_length + NUMBER_OF_BITS_IN_BYTE >= bits_of_file.size()) {
-            if (next_value != ARCHIVE_END) {
-                throw std::runtime_error("error - wrong data in archive file");
-            }
-        } else {
-            if (next_value != ONE_MORE_FILE) {
-                throw std::runtime_error("error - wrong data in archive file");
-            }
-        }
+int Huffman::RunHuffman(const std::vector<size_t>& frequencies_of_alphabet) {
+    vertexes.resize(MAX_NUMBER_OF_VERTEXES);
+    queue_of_vertexes.clear();
+    queue_of_vertexes.reserve(SYMBOLS_COUNT);
 
-        reader.DeleteUselessBitsAtTheBeginning(next_length);
-    }
+    auto comparator_for_vertexes = [&](int a, int b) {
+        return vertexes[a].frequency_of_vertex > vertexes[b].frequency_of_vertex;
+    };
 
-    if (NUMBER_OF_BITS_IN_BYTE < bits_of_file.size()) {
-        throw std::runtime_error("error - wrong data in archive file");
-    }
-}
+    auto push = [&](int vertex) {
+        queue_of_vertexes.push_back(vertex);
+        std::push_heap(queue_of_vertexes.begin(), queue_of_vertexes.end(),
+                       comparator_for_vertexes);
+    };
 
-Vertex* Huffman::RunHuffman(const std::vector<size_t>& frequencies_of_alphabet) const {
-    auto comparator_for_vertexes = [](const Vertex* a, const Vertex* b) {
-        return a->frequency_of_vertex > b->frequency_of_vertex;
+    auto pop = [&]() {
+        std::pop_heap(queue_of_vertexes.begin(), queue_of_vertexes.end(), comparator_for_vertexes);
+        int vertex = queue_of_vertexes.back();
+        queue_of_vertexes.pop_back();
+        return vertex;
     };
 
-    std::priority_queue<Vertex*, std::vector<Vertex*>, decltype(comparator_for_vertexes)> queue(
-        comparator_for_vertexes);
+    int number_of_vertexes = 0;
 
     for (size_t index = 0; index < SYMBOLS_COUNT; ++index) {
         if (frequencies_of_alphabet[index] == 0) {
             continue;
         }
 
-        Vertex* ha = new Vertex();
-        ha->frequency_of_vertex = frequencies_of_alphabet[index];
-        ha->symbol_of_vertex = index;
+        Vertex& leaf = vertexes[number_of_vertexes];
+        leaf = Vertex();
+        leaf.frequency_of_vertex = frequencies_of_alphabet[index];
+        leaf.symbol_of_vertex = index;
 
-        queue.push(ha);
+        push(number_of_vertexes++);
     }
 
-    while (queue.size() > 1) {
-        Vertex* left_child = queue.top();
-        queue.pop();
-
-        Vertex* right_child = queue.top();
-        queue.pop();
+    while (queue_of_vertexes.size() > 1) {
+        int left_child = pop();
+        int right_child = pop();
 
-        Vertex* parent = new Vertex();
-        parent->frequency_of_vertex =
-            left_child->frequency_of_vertex + right_child->frequency_of_vertex;
-        parent->left_child = left_child;
-        parent->right_child = right_child;
+        Vertex& parent = vertexes[number_of_vertexes];
+        parent = Vertex();
+        parent.frequency_of_vertex =
+            vertexes[left_child].frequency_of_vertex + vertexes[right_child].frequency_of_vertex;
+        parent.left_child = left_child;
+        parent.right_child = right_child;
 
-        queue.push(parent);
+        push(number_of_vertexes++);
     }
 
-    assert(queue.size() == 1);
+    assert(queue_of_vertexes.size() == 1);
 
-    return queue.top();
+    return queue_of_vertexes.front();
 }
 
 size_t Huffman::GetNumberOfSymbols(const std::vector<size_t>& frequencies_of_alphabet) const {
@@ -170,83 +205,148 @@ size_t Huffman::GetNumberOfSymbols(const std::vector<size_t>& frequencies_of_alp
     return number_of_symbols;
 }
 
-std::vector<std::vector<bool>> Huffman::GetNewCodeOfSymbols(Vertex* root) const {
-    std::vector<std::vector<bool>> new_code_of_symbol(SYMBOLS_COUNT);
+std::vector<size_t> Huffman::GetLengthsOfCodes(int root) const {
+    std::vector<size_t> length_of_code(SYMBOLS_COUNT);
+    std::vector<size_t> depth_of_vertex(root + 1);
+
+    // Parents are created after their children, so walking down the indices visits every parent
+    // before its children.
+    for (int vertex = root; vertex >= 0; --vertex) {
+        const Vertex& current = vertexes[vertex];
+
+        if (current.symbol_of_vertex != -1) {
+            length_of_code[current.symbol_of_vertex] = depth_of_vertex[vertex];
+            continue;
+        }
+
+        depth_of_vertex[current.left_child] = depth_of_vertex[vertex] + 1;
+        depth_of_vertex[current.right_child] = depth_of_vertex[vertex] + 1;
+    }
+
+    return length_of_code;
+}
+
+std::vector<size_t> Huffman::GetLimitedLengthsOfCodes(
+    const std::vector<size_t>& frequencies_of_alphabet, size_t max_code_size) const {
+    struct Item {
+        size_t frequency = 0;
+        int symbol = -1;
+    };
+
+    std::vector<Item> leaves;
 
-    std::function<void(Vertex*, std::vector<bool>&)> dfs = [&](Vertex* current,
-                                                               std::vector<bool>& current_code) {
-        if (current->symbol_of_vertex != -1) {
-            new_code_of_symbol[current->symbol_of_vertex] = current_code;
-            return;
+    for (size_t symbol = 0; symbol < SYMBOLS_COUNT; ++symbol) {
+        if (frequencies_of_alphabet[symbol] > 0) {
+            leaves.push_back({frequencies_of_alphabet[symbol], static_cast<int>(symbol)});
         }
+    }
+
+    std::stable_sort(leaves.begin(), leaves.end(),
+                     [](const Item& a, const Item& b) { return a.frequency < b.frequency; });
+
+    // items_of_level[level] merges the leaves with the pairs of items of the level below; a
+    // package has symbol -1.
+    std::vector<std::vector<Item>> items_of_level(max_code_size);
+    items_of_level[0] = leaves;
+
+    for (size_t level = 1; level < max_code_size; ++level) {
+        const std::vector<Item>& lower_items = items_of_level[level - 1];
+        std::vector<Item>& items = items_of_level[level];
+
+        size_t leaf_index = 0;
+        size_t package_index = 0;
+
+        while (leaf_index < leaves.size() || package_index + 1 < lower_items.size()) {
+            size_t package_frequency = 0;
 
-        if (current->left_child != nullptr) {
-            current_code.push_back(false);
-            dfs(current->left_child, current_code);
-            current_code.pop_back();
+            if (package_index + 1 < lower_items.size()) {
+                package_frequency = lower_items[package_index].frequency +
+                                    lower_items[package_index + 1].frequency;
+            }
+
+            if (leaf_index < leaves.size() && (package_index + 1 >= lower_items.size() ||
+                                               leaves[leaf_index].frequency <= package_frequency)) {
+                items.push_back(leaves[leaf_index++]);
+            } else {
+                items.push_back({package_frequency, -1});
+                package_index += 2;
+            }
         }
+    }
+
+    // The cheapest 2n - 2 items of the top level are chosen; the packages among the chosen items
+    // of a level are made of a prefix of the level below, and every chosen leaf adds a bit to the
+    // code of its symbol.
+    std::vector<size_t> length_of_code(SYMBOLS_COUNT);
+    size_t number_of_chosen_items = 2 * leaves.size() - 2;
+
+    for (size_t level = max_code_size; level-- > 0;) {
+        size_t number_of_packages = 0;
+
+        for (size_t index = 0; index < number_of_chosen_items; ++index) {
+            const Item& item = items_of_level[level][index];
 
-        if (current->right_child != nullptr) {
-            current_code.push_back(false);
-            dfs(current->right_child, current_code);
-            current_code.pop_back();
+            if (item.symbol == -1) {
+                ++number_of_packages;
+            } else {
+                ++length_of_code[item.symbol];
+            }
         }
-    };
 
-    std::vector<bool> current_code;
-    dfs(root, current_code);
+        number_of_chosen_items = 2 * number_of_packages;
+    }
 
-    return new_code_of_symbol;
+    return length_of_code;
 }
 
 void Huffman::NormalizeCodeOfSymbols(const std::vector<size_t>& frequencies_of_alphabet,
-                                     const std::vector<std::vector<bool>>& new_code_of_symbol,
+                                     const std::vector<size_t>& length_of_code,
                                      size_t number_of_symbols) {
-    std::vector<bool> now_code(new_code_of_symbol[order_of_symbols[0]].size());
+    code_of_symbol.assign(SYMBOLS_COUNT, Code());
 
-    code_of_symbol[order_of_symbols[0]] = now_code;
+    uint32_t now_code = 0;
+    size_t now_length = length_of_code[order_of_symbols[0]];
 
-    for (size_t index = 1; index < number_of_symbols; ++index) {
-        IncrementByOne(now_code);
+    for (size_t index = 0; index < number_of_symbols; ++index) {
+        size_t length = length_of_code[order_of_symbols[index]];
 
-        while (now_code.size() < new_code_of_symbol[order_of_symbols[index]].size()) {
-            now_code.push_back(false);
-        }
+        now_code <<= (length - now_length);
+        now_length = length;
+
+        code_of_symbol[order_of_symbols[index]].bits =
+            static_cast<uint32_t>(DecodingTable::ReverseBits(now_code, length));
+        code_of_symbol[order_of_symbols[index]].length = static_cast<uint8_t>(length);
 
-        code_of_symbol[order_of_symbols[index]] = now_code;
+        ++now_code;
     }
 
-    number_of_codes_with_size = std::vector<int>(now_code.size() + 1);
+    number_of_codes_with_size.assign(now_length + 1, 0);
 
     for (size_t symbol = 0; symbol < SYMBOLS_COUNT; ++symbol) {
         if (frequencies_of_alphabet[symbol] == 0) {
             continue;
         }
 
-        number_of_codes_with_size[new_code_of_symbol[symbol].size()]++;
+        number_of_codes_with_size[length_of_code[symbol]]++;
     }
 }
 
-void Huffman::GetOrderOfSymbols(Reader& reader, std::deque<bool>& bits_of_file,
-                                size_t number_of_symbols) {
-    order_of_symbols = std::vector<int>(number_of_symbols);
+void Huffman::GetOrderOfSymbols(BitReader& reader, size_t number_of_symbols) {
+    order_of_symbols.resize(number_of_symbols);
 
     for (size_t index = 0; index < number_of_symbols; ++index) {
-        order_of_symbols[index] = GetValueOfNextLengthBits(reader, bits_of_file, ALPHABET_SIZE);
-        reader.DeleteUselessBitsAtTheBeginning(ALPHABET_SIZE);
+        order_of_symbols[index] = GetValueOfNextLengthBits(reader, ALPHABET_SIZE);
     }
 }
 
-void Huffman::GetCodeOfSymbols(Reader& reader, std::deque<bool>& bits_of_file,
-                               size_t number_of_symbols) {
+void Huffman::GetCodeOfSymbols(BitReader& reader, size_t number_of_symbols,
+                               size_t lookup_bits) {
     size_t total_number_of_symbols = 0;
     number_of_codes_with_size.clear();
     number_of_codes_with_size.push_back(0);
 
-    while (!bits_of_file.empty() && total_number_of_symbols < number_of_symbols) {
-        number_of_codes_with_size.push_back(
-            GetValueOfNextLengthBits(reader, bits_of_file, ALPHABET_SIZE));
-        reader.DeleteUselessBitsAtTheBeginning(ALPHABET_SIZE);
+    while (!reader.IsEnd() && total_number_of_symbols < number_of_symbols) {
+        number_of_codes_with_size.push_back(GetValueOfNextLengthBits(reader, ALPHABET_SIZE));
 
         total_number_of_symbols += number_of_codes_with_size.back();
     }
@@ -259,102 +359,97 @@ void Huffman::GetCodeOfSymbols(Reader& reader, std::deque<bool>& bits_of_file,
         throw std::runtime_error("error - too much arguments in archive file");
     }
 
-    size_t current_size_of_file = 1;
-
-    while (number_of_codes_with_size[current_size_of_file] == 0) {
-        current_size_of_file++;
-    }
-
-    what_symbol_have_this_code.clear();
+    decoding_table.Build(order_of_symbols, number_of_codes_with_size, lookup_bits);
 
-    std::vector<bool> now_code(current_size_of_file);
+    max_symbol_code_size = decoding_table.max_symbol_code_size;
+}
 
-    code_of_symbol = std::vector<std::vector<bool>>(SYMBOLS_COUNT);
+int Huffman::DecodeNextSymbol(BitReader& reader) const {
+    uint64_t next_bits = reader.Peek(DecodingTable::MAX_TABLE_CODE_SIZE);
 
-    size_t current_symbol = 0;
+    size_t length = 0;
+    int symbol = decoding_table.Decode(next_bits, reader.bits_in_buffer_, length);
 
-    max_symbol_code_size = number_of_codes_with_size.size() - 1;
+    if (symbol == DecodingTable::LONG_CODE_SYMBOL) {
+        next_bits = reader.Peek(DecodingTable::MAX_CODE_SIZE);
+        symbol = decoding_table.DecodeLongCode(
+            next_bits, std::min(reader.bits_in_buffer_, DecodingTable::MAX_CODE_SIZE), length);
+    }
 
-    if (order_of_symbols.empty()) {
+    if (symbol == DecodingTable::INVALID_SYMBOL) {
         throw std::runtime_error("error - wrong data in archive file");
     }
 
-    code_of_symbol[order_of_symbols[current_symbol++]] = now_code;
-    number_of_codes_with_size[current_size_of_file]--;
+    reader.Consume(length);
 
-    while (current_symbol < number_of_symbols) {
-        IncrementByOne(now_code);
-
-        while (now_code.size() <= max_symbol_code_size &&
-               number_of_codes_with_size[current_size_of_file] == 0) {
-            now_code.push_back(false);
-            current_size_of_file++;
-        }
-
-        if (now_code.size() > max_symbol_code_size) {
-            throw std::runtime_error("error - wrong data in archive file");
-        }
+    return symbol;
+}
 
-        code_of_symbol[order_of_symbols[current_symbol++]] = now_code;
-        number_of_codes_with_size[current_size_of_file]--;
+char Huffman::DecodeNextByte(BitReader& reader) const {
+    if (reader.bits_in_buffer_ < DecodingTable::MAX_LOOKUP_BITS) {
+        reader.Refill();
     }
 
-    for (size_t index = 0; index < number_of_symbols; ++index) {
-        what_symbol_have_this_code[code_of_symbol[order_of_symbols[index]]] =
-            order_of_symbols[index];
-    }
-}
+    const uint64_t lookup_mask = decoding_table.primary_table.size() - 1;
+    const DecodingTable::Entry& entry =
+        decoding_table.primary_table[reader.bit_buffer_ & lookup_mask];
 
-int Huffman::FindValueOfNextCode(Reader& reader, const std::deque<bool>& bits) {
-    reader.ReadNextBits();
+    if (entry.symbol >= 0 && entry.symbol < FILENAME_END &&
+        entry.length <= reader.bits_in_buffer_) {
+        reader.bit_buffer_ >>= entry.length;
+        reader.bits_in_buffer_ -= entry.length;
 
-    std::vector<bool> current_code;
+        return static_cast<char>(entry.symbol);
+    }
 
-    for (size_t length = 1; length <= bits.size() && length <= max_symbol_code_size; length++) {
-        current_code.push_back(bits[length - 1]);
+    int symbol = DecodeNextSymbol(reader);
 
-        if (what_symbol_have_this_code.find(current_code) != what_symbol_have_this_code.end()) {
-            return what_symbol_have_this_code[current_code];
-        }
+    if (symbol >= FILENAME_END) {
+        throw std::runtime_error("error - wrong data in archive file");
     }
 
-    throw std::runtime_error("error - wrong data in archive file");
+    return static_cast<char>(symbol);
 }
 
-size_t Huffman::FindLengthOfNextCode(Reader& reader, const std::deque<bool>& bits) {
-    reader.ReadNextBits();
+void Huffman::DecodeInterleavedStreams(const std::vector<BitReader*>& readers, char* output,
+                                       size_t size) const {
+    const size_t number_of_streams = readers.size();
+    const size_t size_of_part = (size + number_of_streams - 1) / number_of_streams;
+    const size_t size_of_last_part = size - std::min(size, size_of_part * (number_of_streams - 1));
 
-    std::vector<bool> current_code;
+    std::vector<char*> parts;
 
-    for (size_t length = 1; length <= bits.size() && length <= max_symbol_code_size; length++) {
-        current_code.push_back(bits[length - 1]);
+    for (size_t stream = 0; stream < number_of_streams; ++stream) {
+        parts.push_back(output + std::min(size, stream * size_of_part));
+    }
 
-        if (what_symbol_have_this_code.find(current_code) != what_symbol_have_this_code.end()) {
-            return length;
+    if (number_of_streams == 4) {
+        DecodeParts<4>(*this, readers.data(), parts.data(), size_of_last_part);
+    } else if (number_of_streams == 1) {
+        DecodeParts<1>(*this, readers.data(), parts.data(), size_of_last_part);
+    } else {
+        for (size_t index = 0; index < size_of_last_part; ++index) {
+            for (size_t stream = 0; stream < number_of_streams; ++stream) {
+                parts[stream][index] = DecodeNextByte(*readers[stream]);
+            }
         }
     }
 
-    throw std::runtime_error("error - wrong data in archive file");
-}
-
-int Huffman::GetValueOfNextLengthBits(Reader& reader, std::deque<bool>& bits, size_t length) const {
-    reader.ReadNextBits();
+    for (size_t stream = 0; stream + 1 < number_of_streams; ++stream) {
+        size_t end = std::min(size, (stream + 1) * size_of_part);
 
-    if (length <= bits.size()) {
-        int value = 0;
-        int power_of_two = 1;
-
-        for (size_t delta_index = 0; delta_index < length; ++delta_index) {
-            if (bits[delta_index]) {
-                value += power_of_two;
-            }
-            power_of_two *= 2;
+        for (char* next = parts[stream] + size_of_last_part; next < output + end; ++next) {
+            *next = DecodeNextByte(*readers[stream]);
         }
+    }
+}
 
-        return value;
+int Huffman::GetValueOfNextLengthBits(BitReader& reader, size_t length) const {
+    if (reader.Available() < length) {
+        throw std::runtime_error("error - wrong data in archive file");
     }
 
-    throw std::runtime_error("error - wrong data in archive file");
+    return static_cast<int>(reader.Read(length));
 }
 
 char Huffman::TransformIntToChar(int value) const {
@@ -364,16 +459,3 @@ char Huffman::TransformIntToChar(int value) const {
 
     return static_cast<char>(value);
 }
-
-void Huffman::IncrementByOne(std::vector<bool>& vec) const {
-    for (size_t index = 0; index < vec.size(); index++) {
-        if (vec[vec.size() - 1 - index]) {
-            vec[vec.size() - 1 - index] = false;
-        } else {
-            vec[vec.size() - 1 - index] = true;
-            return;
-        }
-    }
-
-    throw std::runtime_error("error - wrong data in archive file");
-}
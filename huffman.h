@@ -1,19 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
-#include <deque>
 #include <cassert>
 #include <functional>
 #include <algorithm>
 #include <numeric>
-#include <queue>
-#include <map>
+#include <cstring>
 #include <string>
 #include <exception>
 
 #include "vertex.h"
-#include "writer.h"
-#include "reader.h"
+#include "decoding_table.h"
+#include "bit_writer.h"
+#include "bit_reader.h"
 
 class Huffman {
 public:
@@ -23,39 +23,66 @@ public:
     const static int FILENAME_END;
     const static int ONE_MORE_FILE;
     const static int ARCHIVE_END;
+    const static size_t MAX_CODE_SIZE;
+    const static size_t MIN_CODE_SIZE_LIMIT;
+    const static size_t MAX_NUMBER_OF_VERTEXES;
 
-    Huffman(const std::vector<size_t>& frequencies_of_alphabet);
+    // Code bits are stored reversed, so the first bit of the code is the lowest one.
+    struct Code {
+        uint32_t bits = 0;
+        uint8_t length = 0;
+    };
 
-    Huffman(const char* file_name);
+    // No code is longer than max_code_size, which must be at least MIN_CODE_SIZE_LIMIT.
+    Huffman(const std::vector<size_t>& frequencies_of_alphabet,
+            size_t max_code_size = MAX_CODE_SIZE);
 
-    Vertex* RunHuffman(const std::vector<size_t>& frequencies_of_alphabet) const;
+    Huffman();
+
+    // Builds the codes again, reusing the memory of the previous ones.
+    void Build(const std::vector<size_t>& frequencies_of_alphabet,
+               size_t max_code_size = MAX_CODE_SIZE);
+
+    // Builds the tree in vertexes, children before parents, and returns the index of the root.
+    int RunHuffman(const std::vector<size_t>& frequencies_of_alphabet);
 
     size_t GetNumberOfSymbols(const std::vector<size_t>& frequencies_of_alphabet) const;
 
-    std::vector<std::vector<bool>> GetNewCodeOfSymbols(Vertex* root) const;
+    std::vector<size_t> GetLengthsOfCodes(int root) const;
+
+    // Optimal lengths of codes no longer than max_code_size, found by package-merge.
+    std::vector<size_t> GetLimitedLengthsOfCodes(const std::vector<size_t>& frequencies_of_alphabet,
+                                                 size_t max_code_size) const;
 
     void NormalizeCodeOfSymbols(const std::vector<size_t>& frequencies_of_alphabet,
-                                const std::vector<std::vector<bool>>& new_code_of_symbol,
-                                size_t number_of_symbols);
+                                const std::vector<size_t>& length_of_code, size_t number_of_symbols);
 
-    void GetOrderOfSymbols(Reader& reader, std::deque<bool>& bits_of_file,size_t number_of_symbols);
+    void GetOrderOfSymbols(BitReader& reader, size_t number_of_symbols);
 
-    void GetCodeOfSymbols(Reader& reader,std::deque<bool>& bits_of_file,size_t number_of_symbols);
+    void GetCodeOfSymbols(BitReader& reader, size_t number_of_symbols,
+                          size_t lookup_bits = DecodingTable::LOOKUP_BITS);
 
-    int FindValueOfNextCode(Reader& reader, const std::deque<bool>& bits);
+    int DecodeNextSymbol(BitReader& reader) const;
 
-    size_t FindLengthOfNextCode(Reader& reader, const std::deque<bool>& bits);
+    // Decodes a byte, looking up the primary table without calls when the code is there.
+    char DecodeNextByte(BitReader& reader) const;
 
-    int GetValueOfNextLengthBits(Reader& reader, std::deque<bool>& bits, size_t length) const;
+    // Decodes size bytes to output, split into readers.size() parts of equal size but the last
+    // ones; every part is coded in its own reader, and the readers are decoded in turn.
+    void DecodeInterleavedStreams(const std::vector<BitReader*>& readers, char* output,
+                                  size_t size) const;
 
-    char TransformIntToChar(int value) const;
+    int GetValueOfNextLengthBits(BitReader& reader, size_t length) const;
 
-    void IncrementByOne(std::vector<bool>& vec) const;
+    char TransformIntToChar(int value) const;
 
     size_t max_symbol_code_size;
 
     std::vector<int> order_of_symbols;
     std::vector<int> number_of_codes_with_size;
-    std::map<std::vector<bool>, int> what_symbol_have_this_code;
-    std::vector<std::vector<bool>> code_of_symbol;
+    DecodingTable decoding_table;
+    std::vector<Code> code_of_symbol;
+
+    std::vector<Vertex> vertexes;
+    std::vector<int> queue_of_vertexes;
 };
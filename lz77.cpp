@@ -0,0 +1,198 @@
+#include "lz77.h"
+
+#include <bit>
+
+const size_t Lz77::MIN_LEVEL = 1;
+const size_t Lz77::MAX_LEVEL = 9;
+const size_t Lz77::MIN_MATCH_LENGTH = 4;
+const size_t Lz77::MAX_MATCH_LENGTH = (1 << 16);
+const size_t Lz77::WINDOW_SIZE = (1 << 20);
+const size_t Lz77::MAX_HASH_BITS = 20;
+const int Lz77::END_OF_BLOCK = 256;
+const int Lz77::FIRST_LENGTH_SYMBOL = 259;
+const size_t Lz77::NUMBER_OF_LENGTH_SYMBOLS = 32;
+const size_t Lz77::NUMBER_OF_DISTANCE_SYMBOLS = 40;
+const uint32_t Lz77::NO_POSITION = UINT32_MAX;
+
+namespace {
+
+struct Parameters {
+    size_t max_chain_length;
+    size_t nice_length;
+    bool is_lazy;
+};
+
+const Parameters PARAMETERS_OF_LEVEL[] = {
+    {4, 16, false},  {8, 32, false},  {16, 64, false},   {16, 32, true},     {32, 64, true},
+    {64, 128, true}, {128, 256, true}, {512, 1024, true}, {4096, 65536, true}};
+
+}  // namespace
+
+Lz77::Lz77(size_t level) {
+    if (level < MIN_LEVEL || level > MAX_LEVEL) {
+        throw std::runtime_error("error - wrong level of compression");
+    }
+
+    max_chain_length = PARAMETERS_OF_LEVEL[level - MIN_LEVEL].max_chain_length;
+    nice_length = PARAMETERS_OF_LEVEL[level - MIN_LEVEL].nice_length;
+    is_lazy = PARAMETERS_OF_LEVEL[level - MIN_LEVEL].is_lazy;
+}
+
+void Lz77::FindMatches(const char* data, size_t size, std::vector<Token>& tokens) {
+    tokens.clear();
+
+    // Small buffers get a small table, which is cheaper to clear.
+    hash_bits = std::min<size_t>(MAX_HASH_BITS, std::bit_width(size));
+    head.assign(static_cast<size_t>(1) << hash_bits, NO_POSITION);
+    previous.resize(size);
+
+    size_t next_to_insert = 0;
+    size_t position = 0;
+
+    auto insert_before = [&](size_t end) {
+        for (; next_to_insert < end; ++next_to_insert) {
+            Insert(data, next_to_insert);
+        }
+    };
+
+    while (position < size) {
+        insert_before(position);
+
+        Token match = FindLongestMatch(data, size, position);
+
+        while (is_lazy && match.length >= MIN_MATCH_LENGTH && match.length < nice_length &&
+               position + 1 < size) {
+            insert_before(position + 1);
+
+            Token next_match = FindLongestMatch(data, size, position + 1);
+
+            if (next_match.length <= match.length) {
+                break;
+            }
+
+            tokens.push_back({0, static_cast<unsigned char>(data[position])});
+            ++position;
+            match = next_match;
+        }
+
+        if (match.length < MIN_MATCH_LENGTH) {
+            tokens.push_back({0, static_cast<unsigned char>(data[position])});
+            ++position;
+            continue;
+        }
+
+        tokens.push_back(match);
+        position += match.length;
+
+        // The strings inside a long match are not looked for at fast levels.
+        if (!is_lazy && match.length > nice_length) {
+            next_to_insert = position;
+        }
+    }
+}
+
+Lz77::Token Lz77::FindLongestMatch(const char* data, size_t size, size_t position) const {
+    Token match;
+
+    if (position + MIN_MATCH_LENGTH > size) {
+        return match;
+    }
+
+    size_t max_length = std::min(MAX_MATCH_LENGTH, size - position);
+    uint32_t candidate = head[GetHash(data + position)];
+
+    for (size_t chain = 0; chain < max_chain_length && candidate != NO_POSITION; ++chain) {
+        if (position - candidate > WINDOW_SIZE) {
+            break;
+        }
+
+        // A longer match must also differ from the best one at its last byte, and the strings of
+        // different hashes share a chain.
+        if (data[candidate + match.length] == data[position + match.length] &&
+            std::memcmp(data + candidate, data + position, MIN_MATCH_LENGTH) == 0) {
+            size_t length = GetLengthOfMatch(data + candidate, data + position, max_length);
+
+            if (length > match.length) {
+                match.length = static_cast<uint32_t>(length);
+                match.value = static_cast<uint32_t>(position - candidate);
+
+                if (length >= nice_length || length == max_length) {
+                    break;
+                }
+            }
+        }
+
+        candidate = previous[candidate];
+    }
+
+    return match;
+}
+
+void Lz77::Insert(const char* data, size_t position) {
+    if (position + MIN_MATCH_LENGTH > previous.size()) {
+        return;
+    }
+
+    size_t hash = GetHash(data + position);
+
+    previous[position] = head[hash];
+    head[hash] = static_cast<uint32_t>(position);
+}
+
+size_t Lz77::GetHash(const char* data) const {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+
+    return (word * 2654435761u) >> (32 - hash_bits);
+}
+
+size_t Lz77::GetLengthOfMatch(const char* first, const char* second, size_t max_length) {
+    size_t length = 0;
+
+    while (length + sizeof(uint64_t) <= max_length) {
+        uint64_t first_word;
+        uint64_t second_word;
+        std::memcpy(&first_word, first + length, sizeof(first_word));
+        std::memcpy(&second_word, second + length, sizeof(second_word));
+
+        uint64_t difference = first_word ^ second_word;
+
+        if (difference != 0) {
+            if constexpr (std::endian::native == std::endian::little) {
+                return length + std::countr_zero(difference) / 8;
+            }
+
+            break;
+        }
+
+        length += sizeof(uint64_t);
+    }
+
+    while (length < max_length && first[length] == second[length]) {
+        ++length;
+    }
+
+    return length;
+}
+
+size_t Lz77::GetBucket(uint32_t value) {
+    if (value < 4) {
+        return value;
+    }
+
+    size_t number_of_bits = std::bit_width(value) - 1;
+
+    return 2 * number_of_bits + ((value >> (number_of_bits - 1)) & 1);
+}
+
+uint32_t Lz77::GetBaseOfBucket(size_t bucket) {
+    if (bucket < 4) {
+        return static_cast<uint32_t>(bucket);
+    }
+
+    return static_cast<uint32_t>(2 | (bucket & 1)) << (bucket / 2 - 1);
+}
+
+size_t Lz77::GetNumberOfExtraBits(size_t bucket) {
+    return bucket < 4 ? 0 : bucket / 2 - 1;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+// Finds repeated strings of a buffer with hash chains. A match is coded as a length symbol above
+// ARCHIVE_END of the alphabet of bytes followed by a distance symbol of a second alphabet; both
+// values go to a bucket symbol and extra bits.
+class Lz77 {
+public:
+    const static size_t MIN_LEVEL;
+    const static size_t MAX_LEVEL;
+    const static size_t MIN_MATCH_LENGTH;
+    const static size_t MAX_MATCH_LENGTH;
+    const static size_t WINDOW_SIZE;
+    const static size_t MAX_HASH_BITS;
+    const static int END_OF_BLOCK;
+    const static int FIRST_LENGTH_SYMBOL;
+    const static size_t NUMBER_OF_LENGTH_SYMBOLS;
+    const static size_t NUMBER_OF_DISTANCE_SYMBOLS;
+    const static uint32_t NO_POSITION;
+
+    // A literal byte if length is zero, else a match of length bytes distance bytes back.
+    struct Token {
+        uint32_t length = 0;
+        uint32_t value = 0;
+    };
+
+    // Higher levels follow longer chains and look one byte ahead before taking a match.
+    Lz77(size_t level);
+
+    void FindMatches(const char* data, size_t size, std::vector<Token>& tokens);
+
+    Token FindLongestMatch(const char* data, size_t size, size_t position) const;
+
+    void Insert(const char* data, size_t position);
+
+    size_t GetHash(const char* data) const;
+
+    static size_t GetLengthOfMatch(const char* first, const char* second, size_t max_length);
+
+    // Values 0-3 are buckets of their own; a larger value with n + 1 significant bits goes to
+    // bucket 2n + its second highest bit and has n - 1 extra bits.
+    static size_t GetBucket(uint32_t value);
+
+    static uint32_t GetBaseOfBucket(size_t bucket);
+
+    static size_t GetNumberOfExtraBits(size_t bucket);
+
+    size_t max_chain_length;
+    // A match at least this long is taken at once.
+    size_t nice_length;
+    bool is_lazy;
+
+    size_t hash_bits = 0;
+    std::vector<uint32_t> head;
+    std::vector<uint32_t> previous;
+};
@@ -1,6 +1,121 @@
-#include "archiver.h"
+#include "archive_reader.h"
+
+namespace {
+
+// Writes the contents of the members of the archive, or only of the member named member_name, to
+// stdout one after another.
+void Print(const Archiver& archiver, const std::string& archive_name,
+           const std::string& member_name) {
+    ArchiveReader reader(archive_name, archiver);
+    ArchiveReader::Member member;
+
+    std::vector<char> buffer(Archiver::STREAMING_BLOCK_SIZE);
+
+    while (reader.NextMember(member)) {
+        if (!member_name.empty() && member.name != member_name) {
+            continue;
+        }
+
+        for (size_t size = reader.Read(buffer.data(), buffer.size()); size > 0;
+             size = reader.Read(buffer.data(), buffer.size())) {
+            std::cout.write(buffer.data(), static_cast<std::streamsize>(size));
+        }
+    }
+
+    if (!std::cout.flush()) {
+        throw std::runtime_error("error - cannot write file");
+    }
+}
+
+// Decodes every member of the archive without writing it and prints whether its checksum matches.
+void Test(const Archiver& archiver, const std::string& archive_name) {
+    ArchiveReader reader(archive_name, archiver);
+    ArchiveReader::Member member;
+
+    std::vector<char> buffer(Archiver::STREAMING_BLOCK_SIZE);
+
+    while (reader.NextMember(member)) {
+        while (reader.Read(buffer.data(), buffer.size()) > 0) {
+        }
+
+        std::cout << member.name << ": " << (member.has_checksum ? "ok" : "ok (no checksum)")
+                  << "\n";
+    }
+
+    std::cout.flush();
+}
+
+int Run(int argc, char* argv[]) {
+    Archiver archiver;
+
+    std::vector<char*> arguments;
+
+    for (int index = 0; index < argc; ++index) {
+        if (argv[index] == std::string("--buffer-size") && index + 1 < argc) {
+            archiver.max_buffered_file_size = std::stoull(argv[++index]) << 20;
+        } else if (argv[index] == std::string("-j") && index + 1 < argc) {
+            archiver.number_of_threads = std::clamp(std::stoull(argv[++index]), 1ull,
+                                                    1ull * Archiver::MAX_NUMBER_OF_THREADS);
+        } else if (argv[index] == std::string("-b") && index + 1 < argc) {
+            archiver.block_size =
+                std::min(std::stoull(argv[++index]) << 10, 1ull * Archiver::MAX_BLOCK_SIZE);
+        } else if (argv[index] == std::string("--max-code-size") && index + 1 < argc) {
+            archiver.code_size_limit = std::stoull(argv[++index]);
+
+            if (archiver.code_size_limit < Huffman::MIN_CODE_SIZE_LIMIT ||
+                archiver.code_size_limit > DecodingTable::MAX_LOOKUP_BITS) {
+                std::cout << "Code size limit must be from " << Huffman::MIN_CODE_SIZE_LIMIT
+                          << " to " << DecodingTable::MAX_LOOKUP_BITS << "\n";
+                return 0;
+            }
+        } else if (argv[index] == std::string("--interleave")) {
+            archiver.interleave_streams = true;
+        } else if (argv[index] == std::string("--index")) {
+            archiver.write_index = true;
+        } else if (argv[index] == std::string("--no-index")) {
+            archiver.write_index = false;
+        } else if (argv[index] == std::string("--no-manifest")) {
+            archiver.write_manifest = false;
+        } else if (argv[index] == std::string("--stats") ||
+                   argv[index] == std::string("--io-stats")) {
+            archiver.print_statistics = true;
+        } else if (argv[index] == std::string("--no-checksums")) {
+            archiver.write_checksums = false;
+        } else if (argv[index] == std::string("--block-checksums")) {
+            archiver.block_checksums = true;
+        } else if (argv[index] == std::string("--lz") && index + 1 < argc) {
+            archiver.lz77_level = std::stoull(argv[++index]);
+
+            if (archiver.lz77_level < Lz77::MIN_LEVEL || archiver.lz77_level > Lz77::MAX_LEVEL) {
+                std::cout << "Level of LZ77 must be from " << Lz77::MIN_LEVEL << " to "
+                          << Lz77::MAX_LEVEL << "\n";
+                return 0;
+            }
+        } else if (argv[index] == std::string("--contexts") && index + 1 < argc) {
+            archiver.number_of_contexts = std::stoull(argv[++index]);
+
+            if (archiver.number_of_contexts < 1 ||
+                archiver.number_of_contexts > ContextModel::MAX_NUMBER_OF_CONTEXTS) {
+                std::cout << "Number of contexts must be from 1 to "
+                          << ContextModel::MAX_NUMBER_OF_CONTEXTS << "\n";
+                return 0;
+            }
+        } else if (argv[index] == std::string("--shared-tables") && index + 1 < argc) {
+            archiver.number_of_shared_tables = std::stoull(argv[++index]);
+
+            if (archiver.number_of_shared_tables > Archiver::MAX_NUMBER_OF_SHARED_TABLES) {
+                std::cout << "Number of shared tables must be at most "
+                          << Archiver::MAX_NUMBER_OF_SHARED_TABLES << "\n";
+                return 0;
+            }
+        } else {
+            arguments.push_back(argv[index]);
+        }
+    }
+
+    argc = static_cast<int>(arguments.size());
+    argv = arguments.data();
 
-int main(int argc, char* argv[]) {
     if (argc <= 1) {
         std::cout << "Use \"-h\" to get help\n";
         return 0;
@@ -11,22 +126,102 @@ int main(int argc, char* argv[]) {
                      "and save result to "
                      "file named archive_name\n";
 
+        std::cout << "A directory is archived with everything in it, and a quoted pattern with "
+                     "*, ? or [ is expanded to the files matching it\n";
+
+        std::cout << "Use \"-a archive_name file1 [file2 ...]\" to add files to archive_name, "
+                     "which must have an index, without compressing its files again\n";
+
         std::cout
-            << "Use \"-d archive_name\" to dearchive files from archive_name to current directory";
+            << "Use \"-d archive_name\" to dearchive files from archive_name to current directory\n";
+
+        std::cout << "Use \"-\" as archive_name to write the archive to stdout or read it from "
+                     "stdin, and as a file name to archive stdin; such a file is dearchived to "
+                     "stdout\n";
+
+        std::cout << "Use \"-x archive_name file\" to dearchive only file from archive_name, which "
+                     "must have an index\n";
+
+        std::cout << "Use \"-p archive_name [file]\" to print the contents of all files, or only "
+                     "of file, from archive_name to stdout without creating any files\n";
+
+        std::cout << "Use \"-t archive_name\" to check the checksums of all files in "
+                     "archive_name without creating any files\n";
+
+        std::cout << "Options:\n"
+                     "  -j N               compress or decompress on N threads, at most 256\n"
+                     "  -b N               split files into independent blocks of N KiB, which are "
+                     "compressed and decompressed in parallel\n"
+                     "  --buffer-size N    read files up to N MiB into memory once instead of "
+                     "reading them twice (default 64)\n"
+                     "  --max-code-size N  limit codes to N bits, so that every symbol is "
+                     "decoded by one table lookup; files are split into blocks\n"
+                     "  --interleave       code every block in 4 interleaved streams, which are "
+                     "decoded faster; files are split into blocks\n"
+                     "  --lz N             replace repeated strings by references to them before "
+                     "Huffman coding, searching harder for higher N from 1 to 9; files are split "
+                     "into blocks\n"
+                     "  --contexts N       code every byte by one of at most N tables, chosen by "
+                     "the byte before it, which is better for text; files are split into blocks\n"
+                     "  --no-index         do not write an index of files to the end of the "
+                     "archive, which is needed by -x and to decompress files in parallel\n"
+                     "  --no-manifest      do not write the permissions and times of files and "
+                     "the directories to the archive, so that they are not restored\n"
+                     "  --stats            print sizes, speed and the time of every stage for "
+                     "every file and in total, and the peak memory use, to stderr\n"
+                     "  --no-checksums     do not write a checksum of every file\n"
+                     "  --block-checksums  also write a checksum of every block, so that a damaged "
+                     "block is found before the whole file is decoded\n"
+                     "  --shared-tables N  code files by at most N tables built for files alike, "
+                     "stored once at the start of the archive, instead of a table for every "
+                     "file\n";
         return 0;
     }
 
-    Archiver archiver;
+    if (argv[1] == std::string("-c") && argc > 2) {
+        archiver.Compress(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+        return 0;
+    }
 
-    if (argv[1] == std::string("-c")) {
-        archiver.Compress(argc, argv);
+    if (argv[1] == std::string("-a") && argc > 2) {
+        archiver.Append(argv[2], std::vector<std::string>(argv + 3, argv + argc));
         return 0;
     }
 
-    if (argv[1] == std::string("-d")) {
+    if (argv[1] == std::string("-d") && argc > 2) {
         archiver.Decompress(argv[2]);
         return 0;
     }
 
+    if (argv[1] == std::string("-x") && argc > 3) {
+        archiver.Extract(argv[2], argv[3]);
+        return 0;
+    }
+
+    if (argv[1] == std::string("-p") && argc > 2) {
+        Print(archiver, argv[2], argc > 3 ? argv[3] : "");
+        return 0;
+    }
+
+    if (argv[1] == std::string("-t") && argc > 2) {
+        Test(archiver, argv[2]);
+        return 0;
+    }
+
     std::cout << "Unknown flags\n";
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::ios_base::sync_with_stdio(false);
+
+    try {
+        return Run(argc, argv);
+    } catch (const std::exception& error) {
+        std::cout.flush();
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
 }
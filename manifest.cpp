@@ -0,0 +1,409 @@
+#include "manifest.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MANIFEST_WITH_POSIX
+#include <dirent.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const size_t Manifest::MAX_PATH_SIZE = (1 << 16);
+
+namespace {
+
+const int64_t NANOSECONDS_IN_SECOND = 1000000000;
+
+#ifdef MANIFEST_WITH_POSIX
+Manifest::Entry GetEntry(const std::string& path, const struct stat& status) {
+    Manifest::Entry entry;
+
+    entry.path = path;
+    entry.is_directory = S_ISDIR(status.st_mode);
+    entry.has_metadata = true;
+    entry.mode = status.st_mode & 07777;
+
+#ifdef __APPLE__
+    const struct timespec& time = status.st_mtimespec;
+#else
+    const struct timespec& time = status.st_mtim;
+#endif
+
+    entry.modification_time =
+        static_cast<int64_t>(time.tv_sec) * NANOSECONDS_IN_SECOND + time.tv_nsec;
+
+    return entry;
+}
+#endif
+
+}  // namespace
+
+void Manifest::Add(const std::string& path) {
+    std::string trimmed_path = path;
+
+    while (trimmed_path.size() > 1 && trimmed_path.back() == '/') {
+        trimmed_path.pop_back();
+    }
+
+#ifdef MANIFEST_WITH_POSIX
+    if (trimmed_path.find_first_of("*?[") != std::string::npos) {
+        glob_t matches;
+        int result = glob(trimmed_path.c_str(), 0, nullptr, &matches);
+
+        if (result == GLOB_NOMATCH) {
+            throw std::runtime_error("error - no file matches " + path);
+        }
+
+        if (result != 0) {
+            throw std::runtime_error("error - cannot expand " + path);
+        }
+
+        std::vector<std::string> paths(matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+        globfree(&matches);
+
+        for (const auto& matching_path : paths) {
+            AddEntry(matching_path, AT_FDCWD, matching_path);
+        }
+        return;
+    }
+
+    AddEntry(trimmed_path, AT_FDCWD, trimmed_path);
+#else
+    Entry entry;
+    entry.path = trimmed_path;
+    entry.is_directory = std::filesystem::is_directory(trimmed_path);
+
+    entries.push_back(entry);
+
+    if (!entry.is_directory) {
+        return;
+    }
+
+    for (const auto& directory_entry :
+         std::filesystem::recursive_directory_iterator(trimmed_path)) {
+        if (directory_entry.is_directory() || directory_entry.is_regular_file()) {
+            entries.push_back({directory_entry.path().generic_string(),
+                               directory_entry.is_directory()});
+        }
+    }
+#endif
+}
+
+#ifdef MANIFEST_WITH_POSIX
+void Manifest::AddDirectory(int directory_descriptor, const std::string& path) {
+    std::unique_ptr<DIR, int (*)(DIR*)> directory(fdopendir(directory_descriptor), closedir);
+
+    if (directory == nullptr) {
+        close(directory_descriptor);
+        throw std::runtime_error("error - cannot open directory named " + path);
+    }
+
+    std::vector<std::string> names;
+
+    while (const dirent* directory_entry = readdir(directory.get())) {
+        std::string name = directory_entry->d_name;
+
+        if (name != "." && name != "..") {
+            names.push_back(std::move(name));
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+
+    const std::string prefix = (path.back() == '/' ? path : path + "/");
+
+    for (const auto& name : names) {
+        AddEntry(prefix + name, dirfd(directory.get()), name);
+    }
+}
+
+void Manifest::AddEntry(const std::string& path, int directory_descriptor,
+                        const std::string& name) {
+    // Links are followed only when named on the command line.
+    const bool is_in_directory = (directory_descriptor != AT_FDCWD);
+
+    struct stat status;
+
+    if (fstatat(directory_descriptor, name.c_str(), &status,
+                is_in_directory ? AT_SYMLINK_NOFOLLOW : 0) != 0) {
+        throw std::runtime_error("error - cannot open file named " + path);
+    }
+
+    if (S_ISDIR(status.st_mode)) {
+        entries.push_back(GetEntry(path, status));
+
+        int descriptor =
+            openat(directory_descriptor, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (descriptor < 0) {
+            throw std::runtime_error("error - cannot open directory named " + path);
+        }
+
+        AddDirectory(descriptor, path);
+    } else if (S_ISREG(status.st_mode) || !is_in_directory) {
+        entries.push_back(GetEntry(path, status));
+    }
+}
+#endif
+
+std::vector<std::string> Manifest::GetFileNames() const {
+    std::vector<std::string> file_names;
+
+    for (const auto& entry : entries) {
+        if (!entry.is_directory) {
+            file_names.push_back(entry.path);
+        }
+    }
+
+    return file_names;
+}
+
+std::string Manifest::GetNameInArchive(const std::string& path) {
+    std::string name;
+
+    for (size_t start = 0; start <= path.size();) {
+        size_t end = std::min(path.find('/', start), path.size());
+        std::string_view component(path.data() + start, end - start);
+
+        if (!component.empty() && component != "..") {
+            if (!name.empty()) {
+                name += '/';
+            }
+
+            name += component;
+        }
+
+        start = end + 1;
+    }
+
+    return name.empty() ? "." : name;
+}
+
+bool Manifest::IsSafePath(const std::string& path) {
+    if (path.empty() || path.front() == '/') {
+        return false;
+    }
+
+    for (size_t start = 0; start <= path.size();) {
+        size_t end = std::min(path.find('/', start), path.size());
+
+        if (std::string_view(path.data() + start, end - start) == "..") {
+            return false;
+        }
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+void Manifest::Push(BitWriter& writer) const {
+    PushNumber(writer, entries.size());
+
+    std::string previous_path;
+    uint32_t previous_mode = 0;
+    int64_t previous_time = 0;
+
+    for (const auto& entry : entries) {
+        const std::string path = GetNameInArchive(entry.path);
+
+        size_t size_of_prefix =
+            std::mismatch(previous_path.begin(),
+                          previous_path.begin() + std::min(previous_path.size(), path.size()),
+                          path.begin())
+                .first -
+            previous_path.begin();
+
+        PushNumber(writer, size_of_prefix);
+        PushNumber(writer, path.size() - size_of_prefix);
+        writer.PutBytes(path.data() + size_of_prefix, path.size() - size_of_prefix);
+
+        // The permissions are written only when they differ from the ones before.
+        const bool is_mode_changed = entry.has_metadata && entry.mode != previous_mode;
+
+        PushNumber(writer, (static_cast<uint64_t>(is_mode_changed) << 2) |
+                               (static_cast<uint64_t>(entry.has_metadata) << 1) |
+                               static_cast<uint64_t>(entry.is_directory));
+
+        if (is_mode_changed) {
+            PushNumber(writer, entry.mode);
+            previous_mode = entry.mode;
+        }
+
+        if (entry.has_metadata) {
+            // Times of files written together are close, so their differences are short.
+            int64_t difference = entry.modification_time - previous_time;
+
+            PushNumber(writer, (static_cast<uint64_t>(difference) << 1) ^
+                                   static_cast<uint64_t>(difference >> 63));
+            previous_time = entry.modification_time;
+        }
+
+        previous_path = path;
+    }
+}
+
+void Manifest::Read(BitReader& reader) {
+    uint64_t number_of_entries = ReadNumber(reader);
+
+    entries.clear();
+
+    std::string previous_path;
+    uint32_t previous_mode = 0;
+    int64_t previous_time = 0;
+
+    for (uint64_t index = 0; index < number_of_entries; ++index) {
+        Entry entry;
+
+        uint64_t size_of_prefix = ReadNumber(reader);
+        uint64_t size_of_rest = ReadNumber(reader);
+
+        if (size_of_prefix > previous_path.size() || size_of_rest > MAX_PATH_SIZE) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        entry.path = previous_path.substr(0, size_of_prefix);
+        entry.path.resize(size_of_prefix + size_of_rest);
+        reader.ReadBytes(entry.path.data() + size_of_prefix, size_of_rest);
+
+        uint64_t kind = ReadNumber(reader);
+
+        if (kind > 7 || entry.path.empty()) {
+            throw std::runtime_error("error - wrong data in archive file");
+        }
+
+        if (!IsSafePath(entry.path)) {
+            throw std::runtime_error("error - unsafe path " + entry.path + " in archive");
+        }
+
+        entry.is_directory = kind & 1;
+        entry.has_metadata = (kind >> 1) & 1;
+
+        if ((kind >> 2) & 1) {
+            uint64_t mode = ReadNumber(reader);
+
+            if (mode > 07777) {
+                throw std::runtime_error("error - wrong data in archive file");
+            }
+
+            previous_mode = static_cast<uint32_t>(mode);
+        }
+
+        entry.mode = previous_mode;
+
+        if (entry.has_metadata) {
+            uint64_t difference = ReadNumber(reader);
+
+            entry.modification_time =
+                previous_time + static_cast<int64_t>((difference >> 1) ^ (~(difference & 1) + 1));
+            previous_time = entry.modification_time;
+        }
+
+        previous_path = entry.path;
+        entries.push_back(std::move(entry));
+    }
+}
+
+void Manifest::CreateDirectories() const {
+    std::filesystem::path parent_of_previous_file;
+
+    for (const auto& entry : entries) {
+        if (entry.is_directory) {
+            // The parents of a directory are created before it, unless it was named alone.
+            std::error_code error;
+
+            if (!std::filesystem::create_directory(entry.path, error) && error) {
+                std::filesystem::create_directories(entry.path);
+            }
+            continue;
+        }
+
+        std::filesystem::path parent = std::filesystem::path(entry.path).parent_path();
+
+        if (!parent.empty() && parent != parent_of_previous_file) {
+            std::filesystem::create_directories(parent);
+            parent_of_previous_file = parent;
+        }
+    }
+}
+
+void Manifest::RestoreMetadata() const {
+    for (const auto& entry : entries) {
+        if (!entry.is_directory) {
+            RestoreMetadata(entry);
+        }
+    }
+
+    for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+        if (entry->is_directory) {
+            RestoreMetadata(*entry);
+        }
+    }
+}
+
+void Manifest::RestoreMetadata(const Entry& entry) const {
+    if (!entry.has_metadata || !IsSafePath(entry.path)) {
+        return;
+    }
+
+#ifdef MANIFEST_WITH_POSIX
+    // A link put in place of the file is not followed out of the current directory.
+    struct stat status;
+
+    if (lstat(entry.path.c_str(), &status) != 0 || S_ISLNK(status.st_mode)) {
+        return;
+    }
+
+    int64_t seconds = entry.modification_time / NANOSECONDS_IN_SECOND;
+    int64_t nanoseconds = entry.modification_time % NANOSECONDS_IN_SECOND;
+
+    if (nanoseconds < 0) {
+        nanoseconds += NANOSECONDS_IN_SECOND;
+        --seconds;
+    }
+
+    struct timespec times[2];
+    times[0].tv_sec = 0;
+    times[0].tv_nsec = UTIME_OMIT;
+    times[1].tv_sec = static_cast<time_t>(seconds);
+    times[1].tv_nsec = static_cast<long>(nanoseconds);
+
+    if (chmod(entry.path.c_str(), static_cast<mode_t>(entry.mode)) != 0 ||
+        utimensat(AT_FDCWD, entry.path.c_str(), times, AT_SYMLINK_NOFOLLOW) != 0) {
+        throw std::runtime_error("error - cannot restore metadata of file named " + entry.path);
+    }
+#else
+    std::filesystem::permissions(entry.path, static_cast<std::filesystem::perms>(entry.mode));
+#endif
+}
+
+void Manifest::PushNumber(BitWriter& writer, uint64_t number) {
+    while (number >= 0x80) {
+        writer.Put((number & 0x7F) | 0x80, 8);
+        number >>= 7;
+    }
+
+    writer.Put(number, 8);
+}
+
+uint64_t Manifest::ReadNumber(BitReader& reader) {
+    uint64_t number = 0;
+
+    for (size_t shift = 0; shift < 64; shift += 7) {
+        uint64_t byte = reader.Read(8);
+
+        number |= (byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            return number;
+        }
+    }
+
+    throw std::runtime_error("error - wrong data in archive file");
+}
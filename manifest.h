@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+
+#include "bit_reader.h"
+#include "bit_writer.h"
+
+// The files and directories of an archive with their permissions and modification times, in the
+// order of the members. Every path is written front-coded, as the length of the prefix it shares
+// with the path before it and the rest of it; all numbers are 7 bits per byte, the lowest first,
+// the permissions are written when they change and the times are differences from the time before.
+class Manifest {
+public:
+    const static size_t MAX_PATH_SIZE;
+
+    struct Entry {
+        std::string path;
+        bool is_directory = false;
+        // The permissions and the time are unknown for stdin and are not restored then.
+        bool has_metadata = false;
+        uint32_t mode = 0;
+        // Nanoseconds since the epoch.
+        int64_t modification_time = 0;
+    };
+
+    // Adds the file, or the directory and everything in it, or every path matching a pattern
+    // with *, ? or [.
+    void Add(const std::string& path);
+
+    // Adds what is in the directory, opened as directory_descriptor, sorted by name. Every entry
+    // is looked up relative to the directory, not by its whole path.
+    void AddDirectory(int directory_descriptor, const std::string& path);
+
+    void AddEntry(const std::string& path, int directory_descriptor, const std::string& name);
+
+    // The paths of the files on disk, which are read when they are archived.
+    std::vector<std::string> GetFileNames() const;
+
+    // The path without a leading '/' and without ".." components, as tar stores it, so that it
+    // is decompressed inside the current directory.
+    static std::string GetNameInArchive(const std::string& path);
+
+    // Returns false for an absolute path or one with a ".." component, which is never created,
+    // written or changed when it is read from an archive.
+    static bool IsSafePath(const std::string& path);
+
+    // Pushes every path as GetNameInArchive of it. The writer must stand on a byte boundary.
+    void Push(BitWriter& writer) const;
+
+    // Throws on a path which is not safe. The reader must stand on a byte boundary.
+    void Read(BitReader& reader);
+
+    // Creates all directories at once before the files are written, with their parents first.
+    void CreateDirectories() const;
+
+    // Sets the permissions and times of the files, then the ones of the directories deepest first,
+    // since writing files in a directory changes its time.
+    void RestoreMetadata() const;
+
+    // Skips a path which is not safe or is a link.
+    void RestoreMetadata(const Entry& entry) const;
+
+    // Numbers are written 7 bits a byte, the lowest first, with the high bit set in all bytes but
+    // the last.
+    static void PushNumber(BitWriter& writer, uint64_t number);
+
+    static uint64_t ReadNumber(BitReader& reader);
+
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,93 @@
+#include "statistics.h"
+
+#include <iomanip>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+const size_t FileStatistics::READ = 0;
+const size_t FileStatistics::COUNT = 1;
+const size_t FileStatistics::BUILD = 2;
+const size_t FileStatistics::ENCODE = 3;
+const size_t FileStatistics::DECODE = 4;
+const size_t FileStatistics::WRITE = 5;
+const size_t FileStatistics::NUMBER_OF_STAGES = 6;
+const std::vector<std::string> FileStatistics::NAMES_OF_STAGES = {"read",   "count",  "build",
+                                                                  "encode", "decode", "write"};
+
+void FileStatistics::Add(const FileStatistics& other) {
+    original_size += other.original_size;
+    bytes_read += other.bytes_read;
+    archived_size += other.archived_size;
+
+    for (size_t stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+        seconds_of_stage[stage] += other.seconds_of_stage[stage];
+    }
+}
+
+double FileStatistics::GetSeconds() const {
+    double seconds = 0;
+
+    for (double seconds_of_next_stage : seconds_of_stage) {
+        seconds += seconds_of_next_stage;
+    }
+
+    return seconds;
+}
+
+void FileStatistics::Print(std::ostream& out, double seconds) const {
+    out << name << ": " << original_size << " bytes, " << archived_size << " in archive, "
+        << bytes_read << " read, ratio " << std::fixed << std::setprecision(3)
+        << static_cast<double>(archived_size) / std::max<uint64_t>(1, original_size) << ", "
+        << std::setprecision(1)
+        << (seconds > 0 ? static_cast<double>(original_size) / (1 << 20) / seconds : 0.0)
+        << " MB/s;";
+
+    for (size_t stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+        if (seconds_of_stage[stage] > 0) {
+            out << " " << NAMES_OF_STAGES[stage] << " " << std::setprecision(3)
+                << seconds_of_stage[stage] * 1000 << " ms";
+        }
+    }
+
+    out << "\n";
+}
+
+size_t FileStatistics::GetPeakResidentSetSize() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) << 10;
+#endif
+#else
+    return 0;
+#endif
+}
+
+ScopedTimer::ScopedTimer(FileStatistics& statistics, size_t stage)
+    : seconds_(statistics.is_timed ? &statistics.seconds_of_stage[stage] : nullptr) {
+    if (seconds_ != nullptr) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedTimer::~ScopedTimer() {
+    Stop();
+}
+
+void ScopedTimer::Stop() {
+    if (seconds_ != nullptr) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+        *seconds_ += elapsed.count();
+
+        seconds_ = nullptr;
+    }
+}
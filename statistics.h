@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Sizes of a file and the time of every stage of compressing or decompressing it, or the sums
+// over all files. Stages are timed only if is_timed is set.
+class FileStatistics {
+public:
+    const static size_t READ;
+    const static size_t COUNT;
+    const static size_t BUILD;
+    const static size_t ENCODE;
+    const static size_t DECODE;
+    const static size_t WRITE;
+    const static size_t NUMBER_OF_STAGES;
+    const static std::vector<std::string> NAMES_OF_STAGES;
+
+    void Add(const FileStatistics& other);
+
+    double GetSeconds() const;
+
+    // Prints the sizes, the ratio, the speed over seconds and the time of every stage.
+    void Print(std::ostream& out, double seconds) const;
+
+    // In bytes, or 0 if the system does not tell it.
+    static size_t GetPeakResidentSetSize();
+
+    std::string name;
+    bool is_timed = false;
+    uint64_t original_size = 0;
+    uint64_t bytes_read = 0;
+    uint64_t archived_size = 0;
+    // The CRC-32C of the bytes of the file.
+    uint32_t checksum = 0;
+    std::vector<double> seconds_of_stage = std::vector<double>(NUMBER_OF_STAGES);
+};
+
+// Adds the time from its construction to its destruction, or to Stop, to a stage of statistics.
+// It does not read the clock if the statistics are not timed.
+class ScopedTimer {
+public:
+    ScopedTimer(FileStatistics& statistics, size_t stage);
+
+    ScopedTimer(const ScopedTimer&) = delete;
+
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer();
+
+    // Adds the time so far and stops the timer.
+    void Stop();
+
+    double* seconds_;
+    std::chrono::steady_clock::time_point start_;
+};
@@ -0,0 +1,87 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t number_of_threads) {
+    for (size_t index = 0; index < number_of_threads; ++index) {
+        threads_.emplace_back([this]() { Work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopped_ = true;
+    }
+
+    has_work_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)>& task) {
+    if (threads_.empty()) {
+        for (size_t index = 0; index < count; ++index) {
+            task(index);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    task_ = &task;
+    count_ = count;
+    next_index_ = 0;
+    number_of_finished_ = 0;
+    error_ = nullptr;
+
+    has_work_.notify_all();
+    is_done_.wait(lock, [this]() { return number_of_finished_ == count_; });
+
+    task_ = nullptr;
+    count_ = 0;
+    next_index_ = 0;
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void ThreadPool::Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        has_work_.wait(lock, [this]() { return is_stopped_ || next_index_ < count_; });
+
+        if (is_stopped_) {
+            return;
+        }
+
+        size_t index = next_index_++;
+        const std::function<void(size_t)>* task = task_;
+
+        lock.unlock();
+
+        std::exception_ptr error;
+
+        try {
+            (*task)(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+
+        if (error && !error_) {
+            error_ = error;
+        }
+
+        if (++number_of_finished_ == count_) {
+            is_done_.notify_one();
+        }
+    }
+}
+
+size_t ThreadPool::Size() const {
+    return threads_.size();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    ThreadPool(size_t number_of_threads);
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    // Calls task(index) for every index in [0, count) on the pool threads and waits for all of
+    // them. The first exception thrown by a task is rethrown here.
+    void Run(size_t count, const std::function<void(size_t)>& task);
+
+    void Work();
+
+    size_t Size() const;
+
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable has_work_;
+    std::condition_variable is_done_;
+
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    size_t next_index_ = 0;
+    size_t number_of_finished_ = 0;
+    std::exception_ptr error_;
+    bool is_stopped_ = false;
+};
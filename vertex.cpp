@@ -1,5 +1,4 @@
 #include "vertex.h"
 
-Vertex::Vertex()
-    : symbol_of_vertex(-1), frequency_of_vertex(0), left_child(nullptr), right_child(nullptr) {
+Vertex::Vertex() : symbol_of_vertex(-1), frequency_of_vertex(0), left_child(-1), right_child(-1) {
 }
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstddef>
+
+// A node of the Huffman tree; children are indices in the arena of the tree, -1 for a leaf.
 class Vertex {
 public:
     Vertex();
 
     int symbol_of_vertex = -1;
-    int frequency_of_vertex = 0;
-    Vertex* left_child = nullptr;
-    Vertex* right_child = nullptr;
+    size_t frequency_of_vertex = 0;
+    int left_child = -1;
+    int right_child = -1;
 };